@@ -0,0 +1,211 @@
+/**
+ * Implementation of the bitmap-index parallel top-k dominating query
+ * algorithm.
+ *
+ * @author Sean Chester
+ * @date 17 Oct 2026
+ */
+
+#include "bitmap/bitmap.h"
+
+template class Bitmap< 2 >;
+template class Bitmap< 3 >;
+template class Bitmap< 4 >;
+template class Bitmap< 5 >;
+template class Bitmap< 6 >;
+template class Bitmap< 7 >;
+template class Bitmap< 8 >;
+template class Bitmap< 9 >;
+template class Bitmap< 10 >;
+template class Bitmap< 11 >;
+template class Bitmap< 12 >;
+template class Bitmap< 13 >;
+template class Bitmap< 14 >;
+template class Bitmap< 15 >;
+template class Bitmap< 16 >;
+template class Bitmap< 2, rank_t >;
+template class Bitmap< 3, rank_t >;
+template class Bitmap< 4, rank_t >;
+template class Bitmap< 5, rank_t >;
+template class Bitmap< 6, rank_t >;
+template class Bitmap< 7, rank_t >;
+template class Bitmap< 8, rank_t >;
+template class Bitmap< 9, rank_t >;
+template class Bitmap< 10, rank_t >;
+template class Bitmap< 11, rank_t >;
+template class Bitmap< 12, rank_t >;
+template class Bitmap< 13, rank_t >;
+template class Bitmap< 14, rank_t >;
+template class Bitmap< 15, rank_t >;
+template class Bitmap< 16, rank_t >;
+
+
+template< uint32_t dims, typename V >
+void Bitmap< dims, V >::Init( const Dataset &data ) {
+
+	/* Allocate space. */
+	data_ = new PTuple< dims, V >[ n_ ];
+	owns_data_ = true;
+
+	/* Copy (or rank-transform) data from the dataset into tuple array
+	 * and record point ids. */
+#pragma omp parallel for
+	for ( uint32_t i = 0; i < n_; ++i ) {
+		data_[ i ].pid = i;
+		data_[ i ].score = 0;
+		data_[ i ].partition = 0;
+		const float *row = data.row( i );
+		for( uint32_t d = 0; d < dims; ++d ) {
+			data_[ i ].elems[ d ] = ToSpace< V >( ranks_, d, row[ d ] );
+		}
+	}
+}
+
+
+template< uint32_t dims, typename V >
+void Bitmap< dims, V >::InitInPlace( Dataset &data ) {
+
+	/* Fall back to copying if the rows are not laid out as tuples. */
+	data_ = AdoptTuples< dims, V >( data );
+	if( data_ == NULL ) { Init( data ); return; }
+	owns_data_ = false;
+
+#pragma omp parallel for
+	for ( uint32_t i = 0; i < n_; ++i ) {
+		data_[ i ].pid = i;
+		data_[ i ].score = 0;
+		data_[ i ].partition = 0;
+	}
+}
+
+
+template< uint32_t dims, typename V >
+void Bitmap< dims, V >::assign_bins() {
+
+	bins_.resize( (uint64_t) n_ * dims );
+	std::vector< uint32_t > order( n_ );
+	for( uint32_t d = 0; d < dims; ++d ) {
+
+		/* Sort the point indexes by their values in this dimension. */
+		for( uint32_t i = 0; i < n_; ++i ) { order[ i ] = i; }
+		const PTuple< dims, V > *data = data_;
+		auto less = [ data, d ]( const uint32_t a, const uint32_t b ) {
+			return data[ a ].elems[ d ] < data[ b ].elems[ d ];
+		};
+#if defined(_OPENMP)
+		__gnu_parallel::sort( order.begin(), order.end(), less );
+#else
+		std::sort( order.begin(), order.end(), less );
+#endif
+
+		/* Give each distinct value its own bin if there are few enough; else
+		 * cut into equi-depth bins, keeping each run of equal values in the
+		 * bin of its first point. */
+		uint32_t distinct = ( n_ > 0 );
+		for( uint32_t pos = 1; pos < n_; ++pos ) {
+			distinct += ( data_[ order[ pos ] ].elems[ d ] != data_[ order[ pos - 1 ] ].elems[ d ] );
+		}
+		uint32_t bin = 0, run = 0;
+		for( uint32_t pos = 0; pos < n_; ++pos ) {
+			if( pos > 0 && data_[ order[ pos ] ].elems[ d ] != data_[ order[ pos - 1 ] ].elems[ d ] ) {
+				++run;
+				bin = ( distinct <= BITMAP_BINS ? run : (uint64_t) pos * BITMAP_BINS / n_ );
+			}
+			bins_[ (uint64_t) order[ pos ] * dims + d ] = bin;
+		}
+	}
+}
+
+
+template< uint32_t dims, typename V >
+void Bitmap< dims, V >::build_bitmaps() {
+
+	bitmaps_.assign( (uint64_t) dims * ( BITMAP_BINS + 1 ) * words_, 0 );
+
+	/* First mark each point in the bitmap of its own bin, a word at a time
+	 * so that no two threads write the same word. */
+#pragma omp parallel for
+	for( uint32_t w = 0; w < ( n_ + 63 ) / 64; ++w ) {
+		const uint32_t end = std::min( n_, ( w + 1 ) * 64 );
+		for( uint32_t i = w * 64; i < end; ++i ) {
+			for( uint32_t d = 0; d < dims; ++d ) {
+				bitmap( d, bins_[ (uint64_t) i * dims + d ] )[ w ] |= 1ull << ( i % 64 );
+			}
+		}
+	}
+
+	/* Then range-encode them: bin >= b is bin == b or bin >= b + 1. */
+#pragma omp parallel for
+	for( uint32_t w = 0; w < words_; ++w ) {
+		for( uint32_t d = 0; d < dims; ++d ) {
+			for( int32_t b = BITMAP_BINS - 1; b >= 0; --b ) {
+				bitmap( d, b )[ w ] |= bitmap( d, b + 1 )[ w ];
+			}
+		}
+	}
+}
+
+
+template< uint32_t dims, typename V >
+uint32_t Bitmap< dims, V >::score_point( const uint32_t i ) {
+
+	const uint64_t *maybe[ dims ], *surely[ dims ];
+	for( uint32_t d = 0; d < dims; ++d ) {
+		const uint32_t b = bins_[ (uint64_t) i * dims + d ];
+		maybe[ d ] = bitmap( d, b );
+		surely[ d ] = bitmap( d, b + 1 );
+	}
+
+	uint32_t score = 0;
+	for( uint32_t w = 0; w < words_; w += BITMAP_BLOCK_WORDS ) {
+
+		/* AND a block of words of every dimension's bitmaps (the loops over
+		 * the block vectorize). */
+		uint64_t may[ BITMAP_BLOCK_WORDS ], sure[ BITMAP_BLOCK_WORDS ];
+		for( uint32_t l = 0; l < BITMAP_BLOCK_WORDS; ++l ) {
+			may[ l ] = maybe[ 0 ][ w + l ];
+			sure[ l ] = surely[ 0 ][ w + l ];
+		}
+#pragma GCC unroll 16
+		for( uint32_t d = 1; d < dims; ++d ) {
+			for( uint32_t l = 0; l < BITMAP_BLOCK_WORDS; ++l ) {
+				may[ l ] &= maybe[ d ][ w + l ];
+				sure[ l ] &= surely[ d ][ w + l ];
+			}
+		}
+
+		/* Count the sure ones and test the rest (including point i itself,
+		 * which does not dominate itself). */
+		for( uint32_t l = 0; l < BITMAP_BLOCK_WORDS; ++l ) {
+			score += __builtin_popcountll( sure[ l ] );
+			for( uint64_t tests = may[ l ] & ~sure[ l ]; tests != 0; tests &= tests - 1 ) {
+				const uint32_t j = ( w + l ) * 64 + __builtin_ctzll( tests );
+				score += DominateLeft< dims >( data_[ i ], data_[ j ] );
+			}
+		}
+	}
+	return score;
+}
+
+
+template< uint32_t dims, typename V >
+std::vector< uint32_t > Bitmap< dims, V >::Execute( const uint32_t requested_k ) {
+
+	/* No more than all n_ points can be returned, and the pruning bounds 
+	 * assume that k of them exist. */
+	const uint32_t k = std::min( requested_k, n_ );
+
+	/* First, build the index. */
+	assign_bins();
+	build_bitmaps();
+
+	/* Then, compute the top-k dominating score for every point. */
+#pragma omp parallel for schedule( dynamic, 64 )
+	for( uint32_t i = 0; i < n_; ++i ) {
+		data_[ i ].score = score_point( i );
+	}
+
+	/* Select the k points with the best top-k dominating scores. */
+	result_ = TopKByScore( data_, n_, k );
+	return result_;
+}
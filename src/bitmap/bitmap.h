@@ -0,0 +1,122 @@
+/**
+ * Header file to describe definition of the Bitmap class, a TKDQ solver
+ * that counts dominated points with a bit-sliced index rather than with
+ * pairwise dominance tests.
+ *
+ * @author Sean Chester
+ * @date 17 Oct 2026
+ */
+
+#ifndef BITMAP_H_
+#define BITMAP_H_
+
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#include <parallel/algorithm>
+#else
+#include <algorithm>
+#define omp_get_thread_num() 0
+#define omp_set_num_threads( t ) 0
+#endif
+
+#include "common/common.h"
+#include "common/key_sort.h"
+#include "common/rank_space.h"
+#include "common/tkdq_solver.h"
+
+const uint32_t BITMAP_BINS = 64; /**< The most bins into which a dimension is split */
+const uint32_t BITMAP_BLOCK_WORDS = 8; /**< Words ANDed per step (one zmm, two ymm) */
+
+/**
+ * A class for executing a bitmap-index algorithm to compute top-k
+ * dominating queries.
+ *
+ * Each dimension is sorted once and split into at most BITMAP_BINS bins
+ * of (roughly) equal population, such that equal values share a bin; if
+ * the dimension has few enough distinct values, each gets its own bin.
+ * For every bin b, a range-encoded bitmap (one bit per point) marks the
+ * points with bin >= b. Then, for a point p in bins b_1..b_d, ANDing the
+ * bitmaps of b_1..b_d yields every point that p may dominate, and ANDing
+ * those of b_1+1..b_d+1 yields the points that are strictly worse than p
+ * in every dimension, which p certainly dominates and which are only
+ * popcounted. Only the points in the difference of the two, which share
+ * a bin with p in some dimension, need a dominance test.
+ *
+ * @tparam DIMS The number of dimensions in the input dataset.
+ * @tparam V The type of the tuple values: float, or rank_t to run on
+ * the dataset transformed into rank space (see RankSpace).
+ */
+template< uint32_t DIMS, typename V = float >
+class Bitmap: public TKDQ_Solver {
+
+public:
+
+	/**
+	 * Constructs a new instance of a Bitmap TKDQ solver
+	 * @param ranks The rank space of the dataset; required iff V is rank_t.
+	 * @post Creates a new Bitmap TKDQ solver instance.
+	 */
+  Bitmap( uint32_t threads, uint32_t n, const Dataset &data,
+      const RankSpace *ranks = NULL ) :
+      t_( threads ), n_( n ), ranks_( ranks ) {
+
+    omp_set_num_threads( threads );
+    result_.reserve( 1024 );
+    data_ = NULL;
+    owns_data_ = false;
+    words_ = ( ( n + 63 ) / 64 + BITMAP_BLOCK_WORDS - 1 ) / BITMAP_BLOCK_WORDS * BITMAP_BLOCK_WORDS;
+  }
+
+	~Bitmap() { if( owns_data_ ) { delete[] data_; } }
+  void Init( const Dataset &data );
+  void InitInPlace( Dataset &data );
+	std::vector< uint32_t > Execute( const uint32_t k );
+
+
+protected:
+
+  // Data members:
+  uint32_t n_; /**< The number of points in the dataset. */
+  const uint32_t t_; /**< The number of threads with which the solution should be obtained. */
+  PTuple< DIMS, V > *data_; /**< The internal representation of the dataset. */
+  const RankSpace *ranks_; /**< The rank space of the dataset, if V is rank_t */
+  bool owns_data_; /**< True if data_ was allocated (rather than adopted) */
+  std::vector< uint32_t > result_; /**< The vector that will contain the result point ids */
+
+  uint32_t words_; /**< The words per bitmap: n_ bits, padded to whole blocks */
+  std::vector< uint8_t > bins_; /**< bins_[ i * DIMS + d ] is the bin of point i in dimension d */
+  std::vector< uint64_t > bitmaps_; /**< The BITMAP_BINS + 1 range-encoded bitmaps per dimension */
+
+private:
+
+  /**
+   * Returns the bitmap of the points with bin >= b in dimension d.
+   * Bitmap BITMAP_BINS of every dimension is empty.
+   */
+  uint64_t* bitmap( const uint32_t d, const uint32_t b ) {
+    return &bitmaps_[ ( (uint64_t) d * ( BITMAP_BINS + 1 ) + b ) * words_ ];
+  }
+
+  /**
+   * Sorts every dimension and assigns every point its bin in it.
+   * @post bins_ is populated.
+   */
+  void assign_bins();
+
+  /**
+   * Builds the range-encoded bitmaps from the bins.
+   * @pre assign_bins() has been called.
+   * @post bitmaps_ is populated.
+   */
+  void build_bitmaps();
+
+  /**
+   * Returns the number of points that point i dominates.
+   * @pre build_bitmaps() has been called.
+   */
+  uint32_t score_point( const uint32_t i );
+};
+
+#endif /* BITMAP_H_ */
@@ -15,6 +15,9 @@
 #include <cstring>
 #include <algorithm>
 #include <ostream>
+#include <type_traits>
+
+#include "common/dataset.h"
 
 static const uint32_t SHIFTS[] = { 1 << 0, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1
 		<< 5, 1 << 6, 1 << 7, 1 << 8, 1 << 9, 1 << 10, 1 << 11, 1 << 12, 1 << 13, 1
@@ -28,16 +31,36 @@ static const uint32_t SHIFTS[] = { 1 << 0, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1
 template < typename T >
 void inline swap( T **x, T **y ) { T *tmp = *x; *x = *y; *y = tmp; }
 
+/**
+ * The value type of rank-space tuples: the dense rank of a value among 
+ * the distinct values of its dimension (see RankSpace).
+ */
+typedef uint16_t rank_t;
+
+/**
+ * The number of values that a Tuple reserves for DIMS dimensions: DIMS 
+ * rounded up to a whole number of 16-byte vectors, so that the dominance 
+ * tests can load whole vectors straight from a tuple without reading 
+ * into its pid, score, or partition. The extra values are never 
+ * initialized; the dominance tests mask them out of their results.
+ */
+template< uint32_t DIMS, typename V = float >
+struct PaddedDims {
+  static const uint32_t value = ( DIMS * sizeof( V ) + 15 ) / 16 * 16 / sizeof( V );
+};
+
 /**
  * A Tuple is vector of float values corresponding to one 
  * data object with a unique id.
  * @tparam DIMS The length of the vector of values (i.e., 
  * number of dimensions in the dataset).
+ * @tparam V The type of the values: float, or rank_t for a 
+ * tuple that has been transformed into rank space.
  */
-template< uint32_t DIMS > 
+template< uint32_t DIMS, typename V = float > 
 struct Tuple {
 
-  float elems[ DIMS ]; /**< The ordered vector of data values */
+  V elems[ PaddedDims< DIMS, V >::value ]; /**< The ordered vector of data values (see PaddedDims) */
   uint32_t pid; /**< The unique id for this tuple */
 };
 
@@ -47,8 +70,8 @@ struct Tuple {
  * A score-based tuple is an extension of the Tuple type to 
  * also include a score that is associated with the tuple.
  */
-template< uint32_t DIMS >
-struct STuple: Tuple< DIMS > {
+template< uint32_t DIMS, typename V = float >
+struct STuple: Tuple< DIMS, V > {
 
   float score; // entropy, manhattan sum, or minC
 
@@ -86,10 +109,11 @@ struct STuple: Tuple< DIMS > {
 /**
  * An extension of the score-based tuple type to also 
  * include a  binary mask indicating a partition to 
- * which the tuple belongs.
+ * which the tuple belongs. PTuples are 16-byte aligned, so 
+ * in an array of them every vector of values is aligned, too.
  */
-template< uint32_t DIMS > 
-struct PTuple: STuple < DIMS > {
+template< uint32_t DIMS, typename V = float > 
+struct __attribute__ ((aligned(16))) PTuple: STuple < DIMS, V > {
 
   uint32_t partition; /**< bit mask: 0 is <= pivot, 1 is > pivot on i'th dimension. */
   
@@ -143,12 +167,40 @@ struct PTuple: STuple < DIMS > {
 };
 
 
+/**
+ * Returns the number of floats per row with which a Dataset of d dimensions 
+ * is laid out exactly as an array of PTuple< d >: the padded values (see 
+ * PaddedDims), then pid, score, and partition, rounded up to 16 bytes.
+ */
+constexpr uint32_t TupleRowStride( const uint32_t d ) {
+	return ( ( d + 3 ) / 4 * 4 + 3 + 3 ) / 4 * 4;
+}
+
+/**
+ * Reinterprets the slab of a Dataset as an array of PTuples, provided 
+ * that its rows are already laid out as such.
+ * @param data The dataset to adopt.
+ * @return The first row of data as a PTuple, or NULL if the dimensionality 
+ * or row stride of data does not match PTuple< DIMS >.
+ */
+template< uint32_t DIMS, typename V >
+inline PTuple< DIMS, V >* AdoptTuples( Dataset &data ) {
+	static_assert( TupleRowStride( DIMS ) * sizeof( float ) == sizeof( PTuple< DIMS > ),
+		"TupleRowStride() does not match the layout of PTuple" );
+	if( !std::is_same< V, float >::value || data.num_dims() != DIMS 
+		|| data.row_stride() * sizeof( float ) != sizeof( PTuple< DIMS, V > ) ) {
+		return NULL; /* Rank-space tuples can never be adopted. */
+	}
+	return reinterpret_cast< PTuple< DIMS, V >* >( data.values() );
+}
+
+
 /**
  * Appends a Tuple to the output stream in the form: 
  * [x_1, x_2, ..., x_n ]
  */
-template < uint32_t DIMS >
-std::ostream &operator<<( std::ostream &out, const Tuple< DIMS > &t ) {
+template < uint32_t DIMS, typename V >
+std::ostream &operator<<( std::ostream &out, const Tuple< DIMS, V > &t ) {
 	out << "[ ";
 	for( uint32_t d = 0; d < DIMS; ++d ) {
 		out << t.elems[ d ] << " ";
@@ -162,8 +214,8 @@ std::ostream &operator<<( std::ostream &out, const Tuple< DIMS > &t ) {
  * Appends an STuple to the output stream in the form: 
  * ([x_1, x_2, ..., x_n ], score)
  */
-template < uint32_t DIMS >
-std::ostream &operator<<( std::ostream &out, const STuple< DIMS > &t ) {
+template < uint32_t DIMS, typename V >
+std::ostream &operator<<( std::ostream &out, const STuple< DIMS, V > &t ) {
 	out << "([ ";
 	for( uint32_t d = 0; d < DIMS; ++d ) {
 		out << t.elems[ d ] << " ";
@@ -177,8 +229,8 @@ std::ostream &operator<<( std::ostream &out, const STuple< DIMS > &t ) {
  * Appends a PTuple to the output stream in the form: 
  * ([x_1, x_2, ..., x_n ], score, partition)
  */
-template < uint32_t DIMS >
-std::ostream &operator<<( std::ostream &out, const PTuple< DIMS > &t ) {
+template < uint32_t DIMS, typename V >
+std::ostream &operator<<( std::ostream &out, const PTuple< DIMS, V > &t ) {
 	out << "([ ";
 	for( uint32_t d = 0; d < DIMS; ++d ) {
 		out << t.elems[ d ] << " ";
@@ -203,41 +255,12 @@ inline float get_max(const STuple< NUM_DIMS > &p) {
 
 
 
-#if __AVX__
+#if __SSE4_1__
 
 #include "common/dt_avx2.h"
 
 #else
 
-/**
- * 2-way dominance test with NO assumption for distinct value condition.
- */
-template < uint32_t NUM_DIMS >
-inline int DominanceTest(const Tuple< NUM_DIMS > &t1, const Tuple< NUM_DIMS > &t2) {
-#if COUNT_DT==1
-  __sync_fetch_and_add( &dt_count, 1 );
-#endif
-  bool t1_better = false, t2_better = false;
-
-  for (uint32_t i = 0; i < NUM_DIMS; i++) {
-    if ( t1.elems[i] < t2.elems[i] )
-      t1_better = true;
-    else if ( t1.elems[i] > t2.elems[i] )
-      t2_better = true;
-
-    if ( t1_better && t2_better )
-      return DOM_INCOMP;
-  }
-  if ( !t1_better && t2_better )
-    return DOM_RIGHT;
-  if ( !t2_better && t1_better )
-    return DOM_LEFT;
-
-//    if ( !t1_better && !t2_better )
-//      return DOM_INCOMP; //equal
-  return DOM_INCOMP;
-}
-
 /**
  * Dominance test returning result as a bitmap.
  * This is an original version (assuming distinct value
@@ -257,7 +280,7 @@ inline uint32_t DT_bitmap_dvc(const Tuple< NUM_DIMS > &cur_value, const Tuple< N
       lattice |= SHIFTS[dim];
 
 #if COUNT_DT==1
-  if ( lattice == ALL_ONES)
+  if ( lattice == ((1<<NUM_DIMS) - 1))
     __sync_fetch_and_add( &dt_count_dom, 1 );
   else
     __sync_fetch_and_add( &dt_count_incomp, 1 );
@@ -283,7 +306,7 @@ inline uint32_t DT_bitmap(const Tuple< NUM_DIMS > &cur_value, const Tuple< NUM_D
       lattice |= SHIFTS[dim];
 
 #if COUNT_DT==1
-  if ( lattice == ALL_ONES)
+  if ( lattice == ((1<<NUM_DIMS) - 1))
     __sync_fetch_and_add( &dt_count_dom, 1 );
   else
     __sync_fetch_and_add( &dt_count_incomp, 1 );
@@ -350,6 +373,8 @@ inline int DominateLeftDVC(const Tuple< NUM_DIMS > &t1, const Tuple< NUM_DIMS >
 
 #endif
 
+#include "common/dt_rank.h"
+
 /**
  * Dominance test that computes a bitmap.
  * Produces side-effects in cur_value: sets score 
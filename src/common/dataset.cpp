@@ -0,0 +1,78 @@
+/**
+ * Implementation of the Dataset container.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#include "common/dataset.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/mman.h>
+
+Dataset::Dataset( const uint32_t n, const uint32_t d, const bool huge_pages,
+	const bool first_touch, const uint32_t row_stride ) 
+	: n_( n ), d_( d ), stride_( row_stride > d ? row_stride : d ), owned_( true ) {
+
+	/* Round the slab up to whole alignment units so that it can be advised. */
+	const size_t alignment = huge_pages ? HUGE_PAGE_SIZE : DATASET_ALIGNMENT;
+	const size_t bytes = (uint64_t) n * stride_ * sizeof( float );
+	const size_t padded_bytes = ( ( bytes + alignment - 1 ) / alignment ) * alignment;
+
+	void *slab = NULL;
+	if( posix_memalign( &slab, alignment, padded_bytes > 0 ? padded_bytes : alignment ) != 0 ) {
+		printf( "Can't allocate %lu bytes for the dataset\n", (unsigned long) bytes );
+		exit( EXIT_FAILURE );
+	}
+	values_ = (float*) slab;
+
+#ifdef MADV_HUGEPAGE
+	if( huge_pages ) { madvise( slab, padded_bytes, MADV_HUGEPAGE ); }
+#endif
+
+	/* Touch every row from the thread that will own it under a static schedule. */
+	if( first_touch ) {
+#pragma omp parallel for schedule( static )
+		for( uint32_t i = 0; i < n_; ++i ) {
+			memset( row( i ), 0, sizeof( float ) * stride_ );
+		}
+	}
+}
+
+Dataset::Dataset( float *values, const uint32_t n, const uint32_t d )
+	: values_( values ), n_( n ), d_( d ), stride_( d ), owned_( false ) { }
+
+void Dataset::Normalize( const float *min, const float *max ) {
+
+	float range[ d_ ];
+	for( uint32_t j = 0; j < d_; ++j ) {
+		range[ j ] = max[ j ] > min[ j ] ? max[ j ] - min[ j ] : 1;
+	}
+
+#pragma omp parallel for schedule( static )
+	for( uint32_t i = 0; i < n_; ++i ) {
+		float *values = row( i );
+#pragma omp simd
+		for( uint32_t j = 0; j < d_; ++j ) {
+			values[ j ] = ( values[ j ] - min[ j ] ) / range[ j ];
+		}
+	}
+}
+
+void Dataset::PermuteDimensions( const uint32_t *order ) {
+
+#pragma omp parallel for schedule( static )
+	for( uint32_t i = 0; i < n_; ++i ) {
+		float *values = row( i );
+		float original[ d_ ];
+		for( uint32_t j = 0; j < d_; ++j ) { original[ j ] = values[ j ]; }
+		for( uint32_t j = 0; j < d_; ++j ) { values[ j ] = original[ order[ j ] ]; }
+	}
+}
+
+Dataset::~Dataset() {
+	if( owned_ ) { free( values_ ); }
+}
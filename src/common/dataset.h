@@ -0,0 +1,121 @@
+/**
+ * A contiguous container for an input dataset.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#ifndef DATASET_H_
+#define DATASET_H_
+
+#include <stdint.h>
+#include <cstddef>
+
+const size_t DATASET_ALIGNMENT = 64; /**< Byte alignment of the slab (a cache line) */
+const size_t HUGE_PAGE_SIZE = 2 << 20; /**< Alignment used when requesting huge pages */
+
+/**
+ * A strided, read-only view of one dimension of a Dataset.
+ */
+struct ColumnView {
+	const float *base; /**< The value of the first point in this dimension */
+	uint32_t stride; /**< The number of floats between consecutive points */
+	uint32_t n; /**< The number of points */
+
+	float operator[]( const uint32_t i ) const { return base[ (uint64_t) i * stride ]; }
+	uint32_t size() const { return n; }
+};
+
+/**
+ * A dataset of n points in d dimensions, stored row-major in a single
+ * 64-byte-aligned slab of memory, so that value j of point i is at
+ * values()[ i * row_stride() + j ]. The row stride is normally d, but
+ * can be larger in order to reserve room after the values of each point,
+ * e.g., so that the rows are laid out exactly as solver tuples and can be
+ * adopted in place (see TKDQ_Solver::InitInPlace()).
+ *
+ * By default, the slab is zeroed by all threads in parallel with a static
+ * schedule, so that, under a first-touch page placement policy, each page
+ * resides on the socket of the thread that will (under the same static
+ * schedule) later process it. A Dataset can also wrap memory that it does
+ * not own, such as a mapped binary dataset.
+ */
+class Dataset {
+
+public:
+
+	/**
+	 * Allocates a new (owning) dataset.
+	 * @param n The number of points.
+	 * @param d The number of dimensions.
+	 * @param huge_pages True if the slab should be aligned to, and advised
+	 * to be backed by, transparent huge pages (MADV_HUGEPAGE).
+	 * @param first_touch True if the slab should be zeroed in parallel.
+	 * Pass false if the caller will itself fill it in parallel.
+	 * @param row_stride The number of floats per row (at least d), or 0
+	 * for a dense layout of d floats per row.
+	 */
+	Dataset( const uint32_t n, const uint32_t d, const bool huge_pages = false,
+		const bool first_touch = true, const uint32_t row_stride = 0 );
+
+	/**
+	 * Wraps existing row-major memory without taking ownership of it.
+	 * @param values A row-major array of n * d floats that outlives this.
+	 * @param n The number of points.
+	 * @param d The number of dimensions.
+	 */
+	Dataset( float *values, const uint32_t n, const uint32_t d );
+
+	/**
+	 * Releases the slab, if it is owned by this dataset.
+	 */
+	~Dataset();
+
+	Dataset( const Dataset& ) = delete;
+	Dataset& operator=( const Dataset& ) = delete;
+
+	uint32_t num_points() const { return n_; } /**< Returns n */
+	uint32_t num_dims() const { return d_; } /**< Returns d */
+	uint32_t row_stride() const { return stride_; } /**< Floats per row */
+	bool owns_memory() const { return owned_; } /**< True unless wrapping */
+
+	/** Returns the first value of the slab. */
+	float* values() { return values_; }
+	const float* values() const { return values_; }
+
+	/** Returns the d values of point i. */
+	float* row( const uint32_t i ) { return values_ + (uint64_t) i * stride_; }
+	const float* row( const uint32_t i ) const { return values_ + (uint64_t) i * stride_; }
+
+	/**
+	 * Rescales every dimension to [0,1] in place, i.e., replaces each value 
+	 * x of dimension j with ( x - min[ j ] ) / ( max[ j ] - min[ j ] ).
+	 * @param min The minimum value of each dimension.
+	 * @param max The maximum value of each dimension.
+	 * @post Dimensions with min[ j ] == max[ j ] are set to 0.
+	 */
+	void Normalize( const float *min, const float *max );
+
+	/**
+	 * Permutes the dimensions of every point in place, i.e., replaces 
+	 * value j of each point with its value order[ j ].
+	 * @param order A permutation of 0..d-1.
+	 */
+	void PermuteDimensions( const uint32_t *order );
+
+	/** Returns a view of the n values of dimension j. */
+	ColumnView column( const uint32_t j ) const {
+		ColumnView view = { values_ + j, stride_, n_ };
+		return view;
+	}
+
+private:
+
+	float *values_; /**< The slab */
+	uint32_t n_; /**< The number of points */
+	uint32_t d_; /**< The number of dimensions */
+	uint32_t stride_; /**< The number of floats per row */
+	bool owned_; /**< True if values_ should be freed by this */
+};
+
+#endif /* DATASET_H_ */
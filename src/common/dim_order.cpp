@@ -0,0 +1,92 @@
+/**
+ * Implementation of the selectivity-based ordering of dimensions.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#include "common/dim_order.h"
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * Returns the number of dimensions that a dominance test scans on a pair
+ * whose failing dimensions are marked in mask, in the given order: up to 
+ * and including the first failing one, or all of them.
+ */
+uint32_t dims_scanned( const uint32_t mask, const std::vector< uint32_t > &order ) {
+	for( uint32_t j = 0; j < order.size(); ++j ) {
+		if( mask & ( 1u << order[ j ] ) ) { return j + 1; }
+	}
+	return order.size();
+}
+
+/**
+ * Returns the mean of dims_scanned() over all the masks.
+ */
+double mean_dims_scanned( const std::vector< uint32_t > &masks, 
+	const std::vector< uint32_t > &order ) {
+
+	uint64_t total = 0;
+	for( uint32_t p = 0; p < masks.size(); ++p ) {
+		total += dims_scanned( masks[ p ], order );
+	}
+	return masks.empty() ? 0 : total / (double) masks.size();
+}
+
+} // namespace
+
+DimensionOrder EstimateDimensionOrder( const Dataset &data, const uint32_t sample_size ) {
+
+	const uint32_t n = data.num_points(), d = data.num_dims();
+	const uint32_t s = std::min( n, sample_size );
+
+	/* For every ordered pair (a, b) of the sample, mark the dimensions in 
+	 * which a is worse than b, i.e., that rule out that a dominates b. */
+	std::vector< uint32_t > masks;
+	masks.reserve( (uint64_t) s * s );
+	for( uint32_t a = 0; a < s; ++a ) {
+		const float *left = data.row( (uint64_t) a * n / s );
+		for( uint32_t b = 0; b < s; ++b ) {
+			if( a == b ) { continue; }
+			const float *right = data.row( (uint64_t) b * n / s );
+			uint32_t mask = 0;
+			for( uint32_t j = 0; j < d; ++j ) {
+				if( left[ j ] > right[ j ] ) { mask |= 1u << j; }
+			}
+			masks.push_back( mask );
+		}
+	}
+
+	DimensionOrder result;
+	std::vector< uint32_t > file_order( d );
+	for( uint32_t j = 0; j < d; ++j ) { file_order[ j ] = j; }
+	result.dims_per_test_before = mean_dims_scanned( masks, file_order );
+
+	/* Greedily pick the dimension that rules out the most open pairs. */
+	std::vector< uint32_t > open( masks );
+	uint32_t remaining = ( 1u << d ) - 1;
+	for( uint32_t pos = 0; pos < d; ++pos ) {
+		std::vector< uint32_t > ruled_out( d, 0 );
+		for( uint32_t p = 0; p < open.size(); ++p ) {
+			for( uint32_t j = 0; j < d; ++j ) {
+				ruled_out[ j ] += ( open[ p ] >> j ) & 1;
+			}
+		}
+		uint32_t best = d;
+		for( uint32_t j = 0; j < d; ++j ) {
+			if( ( remaining & ( 1u << j ) ) && ( best == d || ruled_out[ j ] > ruled_out[ best ] ) ) {
+				best = j;
+			}
+		}
+		result.order.push_back( best );
+		remaining &= ~( 1u << best );
+		open.erase( std::remove_if( open.begin(), open.end(),
+			[ best ]( const uint32_t mask ) { return ( mask >> best ) & 1; } ), open.end() );
+	}
+
+	result.dims_per_test_after = mean_dims_scanned( masks, result.order );
+	return result;
+}
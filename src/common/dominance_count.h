@@ -0,0 +1,136 @@
+/**
+ * Batched dominance counting: the number of points in a range of a block
+ * that one point dominates, which is what every solver sums up to compute
+ * top-k dominating scores, and the number that dominate it, which only
+ * matters until it reaches k (at which point the point is pruned).
+ *
+ * A block is either an array of PTuples, which is scanned with one
+ * pairwise dominance test per point, or its SoATiles copy, which is
+ * scanned a whole tile (TILE_WIDTH points) per test. The tile tests are
+ * unrolled over the DIMS dimensions at compile time.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#ifndef DOMINANCE_COUNT_H_
+#define DOMINANCE_COUNT_H_
+
+#include <stdint.h>
+
+#include "common/common.h"
+#include "common/soa_tiles.h"
+
+/**
+ * The number of points that count_dominators() tests between checks of 
+ * its limit. The checks stay out of the inner loop, which is unrolled and 
+ * branch-free, while a pruned point scans at most this many points (two 
+ * tiles, or at most 1 KB of tuples, so a block stays in L1 next to p) 
+ * past its k'th dominator.
+ */
+const uint32_t DOMINATOR_BLOCK = 16;
+
+/**
+ * Returns the number of points in [begin, end) of an array of tuples
+ * that p dominates.
+ */
+template< uint32_t DIMS, typename V >
+inline uint32_t count_dominated( const Tuple< DIMS, V > &p,
+	const PTuple< DIMS, V > *points, const uint32_t begin, const uint32_t end ) {
+
+	uint32_t count = 0;
+	for( uint32_t j = begin; j < end; ++j ) {
+		count += DominateLeft< DIMS >( p, points[ j ] );
+	}
+	return count;
+}
+
+/**
+ * Returns the number of points in [begin, end) of a tiled block that p
+ * dominates. The tiles that the range only partially covers are masked
+ * to the lanes within it.
+ */
+template< uint32_t DIMS, typename V >
+inline uint32_t count_dominated( const Tuple< DIMS, V > &p,
+	const SoATiles< DIMS, V > &points, const uint32_t begin, const uint32_t end ) {
+
+	if( begin >= end ) { return 0; }
+	const uint32_t first = begin / TILE_WIDTH, last = ( end - 1 ) / TILE_WIDTH;
+	const uint32_t head = ~0u << ( begin % TILE_WIDTH ); // lanes >= begin
+	const uint32_t tail = ( 2u << ( ( end - 1 ) % TILE_WIDTH ) ) - 1; // lanes < end
+
+	if( first == last ) {
+		return __builtin_popcount( DominatesMask( p, points.tile( first ) ) & head & tail );
+	}
+	uint32_t count = __builtin_popcount( DominatesMask( p, points.tile( first ) ) & head );
+	for( uint32_t t = first + 1; t < last; ++t ) {
+		count += __builtin_popcount( DominatesMask( p, points.tile( t ) ) );
+	}
+	return count + __builtin_popcount( DominatesMask( p, points.tile( last ) ) & tail );
+}
+
+/**
+ * Returns the number of points in [begin, end) of an array of tuples 
+ * that dominate p, but stops as soon as that number reaches limit (in 
+ * which case it may exceed limit).
+ */
+template< uint32_t DIMS, typename V >
+inline uint32_t count_dominators( const Tuple< DIMS, V > &p,
+	const PTuple< DIMS, V > *points, const uint32_t begin, const uint32_t end,
+	const uint32_t limit ) {
+
+	uint32_t count = 0;
+	for( uint32_t j = begin; j < end && count < limit; ) {
+		const uint32_t stop = std::min( end, j + DOMINATOR_BLOCK );
+		for( ; j < stop; ++j ) {
+			count += DominateLeft< DIMS >( points[ j ], p );
+		}
+	}
+	return count;
+}
+
+/**
+ * As count_dominators() on an array of tuples, but only testing the 
+ * num points at the given indexes.
+ */
+template< uint32_t DIMS, typename V >
+inline uint32_t count_dominators_at( const Tuple< DIMS, V > &p,
+	const PTuple< DIMS, V > *points, const uint32_t *indexes, const uint32_t num,
+	const uint32_t limit ) {
+
+	uint32_t count = 0;
+	for( uint32_t j = 0; j < num && count < limit; ) {
+		const uint32_t stop = std::min( num, j + DOMINATOR_BLOCK );
+		for( ; j < stop; ++j ) {
+			count += DominateLeft< DIMS >( points[ indexes[ j ] ], p );
+		}
+	}
+	return count;
+}
+
+/**
+ * As count_dominators() on an array of tuples, but on a tiled block, 
+ * testing a whole tile per instruction.
+ */
+template< uint32_t DIMS, typename V >
+inline uint32_t count_dominators( const Tuple< DIMS, V > &p,
+	const SoATiles< DIMS, V > &points, const uint32_t begin, const uint32_t end,
+	const uint32_t limit ) {
+
+	if( begin >= end ) { return 0; }
+	const uint32_t first = begin / TILE_WIDTH, last = ( end - 1 ) / TILE_WIDTH;
+	const uint32_t head = ~0u << ( begin % TILE_WIDTH ); // lanes >= begin
+	const uint32_t tail = ( 2u << ( ( end - 1 ) % TILE_WIDTH ) ) - 1; // lanes < end
+
+	uint32_t count = 0;
+	for( uint32_t t = first; t <= last && count < limit; ) {
+		const uint32_t stop = std::min( last + 1, t + DOMINATOR_BLOCK / TILE_WIDTH );
+		for( ; t < stop; ++t ) {
+			const uint32_t lanes = ( t == first ? head : ~0u ) & ( t == last ? tail : ~0u );
+			count += __builtin_popcount( DominatedByMask( p, points.tile( t ) ) & lanes );
+		}
+	}
+	return count;
+}
+
+#endif /* DOMINANCE_COUNT_H_ */
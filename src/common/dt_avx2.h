@@ -4,7 +4,8 @@
  *  Created on: Dec 2, 2014
  *      Author: sidlausk
  *
- *  Templated (v2) dominance tests using AVX/SSE instructions.
+ *  Templated (v2) dominance tests using AVX-512/AVX/SSE instructions,
+ *  whichever the build targets (see util/isa_dispatch.h).
  */
 
 #ifndef DT_AVX2_H_
@@ -13,61 +14,67 @@
 #include <immintrin.h>  // AVX
 #include <iostream>
 
-template< uint32_t DIMS >
-inline uint32_t DT_bitmap_dvc(const Tuple<DIMS> &cur, const Tuple<DIMS> &sky) {
-#if COUNT_DT==1
-  __sync_fetch_and_add( &dt_count, 1 );
-#endif
+/**
+ * Compares two tuples dimension by dimension, returning a bitmap in which
+ * bit i is set iff left.elems[ i ] PRED right.elems[ i ]. Tuples are padded
+ * to whole 16-byte vectors (see PaddedDims), so the values are loaded
+ * straight from the tuples, without copies or a scalar tail; the bits of
+ * the padding values are masked out. With AVX-512, one masked compare
+ * writes the bitmap straight into a mask register instead.
+ * @tparam PRED An AVX comparison predicate: _CMP_LE_OS or _CMP_LT_OS.
+ */
+template< int PRED, uint32_t DIMS >
+inline uint32_t cmp_mask(const Tuple<DIMS> &left, const Tuple<DIMS> &right) {
+  static_assert(PRED == _CMP_LE_OS || PRED == _CMP_LT_OS, "unsupported predicate");
 
-  uint32_t lattice = 0;
+#if __AVX512F__ && __AVX512VL__
+  const uint32_t padded_dims = PaddedDims< DIMS >::value;
+  uint32_t mask = 0;
+  uint32_t dim = 0;
+  for (; dim + 8 <= padded_dims; dim += 8) {
+    mask |= _mm256_cmp_ps_mask(_mm256_loadu_ps(left.elems + dim),
+        _mm256_loadu_ps(right.elems + dim), PRED) << dim;
+  }
+  if (dim < padded_dims) {
+    mask |= _mm_cmp_ps_mask(_mm_loadu_ps(left.elems + dim),
+        _mm_loadu_ps(right.elems + dim), PRED) << dim;
+  }
+  return mask & ((1 << DIMS) - 1);
+#else
+  const uint32_t padded_dims = PaddedDims< DIMS >::value;
+  uint32_t mask = 0;
   uint32_t dim = 0;
 
-  if ( DIMS >= 8) {
-    const Tuple<DIMS> __attribute__ ((aligned(32))) cur_value = cur;
-    const Tuple<DIMS> __attribute__ ((aligned(32))) sky_value = sky;
-
-    for (; dim + 8 <= DIMS; dim += 8) {
-      __m256 p_ymm = _mm256_load_ps(cur_value.elems + dim);
-      __m256 sky_ymm = _mm256_load_ps(sky_value.elems + dim);
-      __m256 comp_le = _mm256_cmp_ps(sky_ymm, p_ymm, 2);
-      uint32_t le_mask = _mm256_movemask_ps(comp_le);
-      lattice = lattice | (le_mask << dim);
-    }
-
-    for (; dim + 4 <= DIMS; dim += 4) {
-      __m128 p_xmm = _mm_load_ps(cur_value.elems + dim);
-      __m128 sky_xmm = _mm_load_ps(sky_value.elems + dim);
-      __m128 le128 = _mm_cmp_ps(sky_xmm, p_xmm, 2);
-      uint32_t le_mask = _mm_movemask_ps(le128);
-      lattice = lattice | (le_mask << dim);
-    }
-
-    for (; dim < DIMS; ++dim)
-      if (sky.elems[dim] <= cur.elems[dim])
-        lattice |= SHIFTS[dim];
-
-  } else if (DIMS >= 4) {
-    const Tuple<DIMS> __attribute__ ((aligned(32))) cur_value = cur;
-    const Tuple<DIMS> __attribute__ ((aligned(32))) sky_value = sky;
+#if __AVX__
+  for (; dim + 8 <= padded_dims; dim += 8) {
+    __m256 left_ymm = _mm256_loadu_ps(left.elems + dim);
+    __m256 right_ymm = _mm256_loadu_ps(right.elems + dim);
+    mask |= _mm256_movemask_ps(_mm256_cmp_ps(left_ymm, right_ymm, PRED)) << dim;
+  }
+#endif
 
-    for (; dim + 4 <= DIMS; dim += 4) {
-      __m128 p_xmm = _mm_load_ps(cur_value.elems + dim);
-      __m128 sky_xmm = _mm_load_ps(sky_value.elems + dim);
-      __m128 comp_le = _mm_cmp_ps(sky_xmm, p_xmm, 2);
-      uint32_t le_mask = _mm_movemask_ps(comp_le);
-      lattice = lattice | (le_mask << dim);
-    }
+  for (; dim < padded_dims; dim += 4) {
+    __m128 left_xmm = _mm_loadu_ps(left.elems + dim);
+    __m128 right_xmm = _mm_loadu_ps(right.elems + dim);
+#if __AVX__
+    mask |= _mm_movemask_ps(_mm_cmp_ps(left_xmm, right_xmm, PRED)) << dim;
+#else
+    mask |= _mm_movemask_ps(PRED == _CMP_LE_OS ? _mm_cmple_ps(left_xmm, right_xmm)
+        : _mm_cmplt_ps(left_xmm, right_xmm)) << dim;
+#endif
+  }
 
-    for (; dim < DIMS; ++dim)
-      if (sky.elems[dim] <= cur.elems[dim])
-        lattice |= SHIFTS[dim];
+  return mask & ((1 << DIMS) - 1);
+#endif
+}
 
-  } else {
+template< uint32_t DIMS >
+inline uint32_t DT_bitmap_dvc(const Tuple<DIMS> &cur, const Tuple<DIMS> &sky) {
+#if COUNT_DT==1
+  __sync_fetch_and_add( &dt_count, 1 );
+#endif
 
-    for (; dim < DIMS; ++dim)
-      if (sky.elems[dim] <= cur.elems[dim])
-        lattice |= SHIFTS[dim];
-  }
+  const uint32_t lattice = cmp_mask<_CMP_LE_OS>(sky, cur);
 
 #if COUNT_DT==1
   if ( lattice == ((1<<DIMS) - 1) )
@@ -79,59 +86,13 @@ inline uint32_t DT_bitmap_dvc(const Tuple<DIMS> &cur, const Tuple<DIMS> &sky) {
   return lattice;
 }
 
-template<int DIMS>
-inline uint32_t DT_bitmap(const Tuple<DIMS> cur, const Tuple<DIMS> sky) {
+template< uint32_t DIMS >
+inline uint32_t DT_bitmap(const Tuple<DIMS> &cur, const Tuple<DIMS> &sky) {
 #if COUNT_DT==1
   __sync_fetch_and_add( &dt_count, 1 );
 #endif
-  uint32_t lattice = 0;
-  uint32_t dim = 0;
 
-  if (DIMS >= 8) {
-    const Tuple<DIMS> __attribute__ ((aligned(32))) cur_value = cur;
-    const Tuple<DIMS> __attribute__ ((aligned(32))) sky_value = sky;
-
-    for (; dim + 8 <= DIMS; dim += 8) {
-      __m256 p_ymm = _mm256_load_ps(cur_value.elems + dim);
-      __m256 sky_ymm = _mm256_load_ps(sky_value.elems + dim);
-      __m256 comp_lt = _mm256_cmp_ps(sky_ymm, p_ymm, 1);
-      uint32_t lt_mask = _mm256_movemask_ps(comp_lt);
-      lattice = lattice | (lt_mask << dim);
-    }
-
-    for (; dim + 4 <= DIMS; dim += 4) {
-      __m128 p_xmm = _mm_load_ps(cur_value.elems + dim);
-      __m128 sky_xmm = _mm_load_ps(sky_value.elems + dim);
-      __m128 comp_lt = _mm_cmp_ps(sky_xmm, p_xmm, 1);
-      uint32_t lt_mask = _mm_movemask_ps(comp_lt);
-      lattice = lattice | (lt_mask << dim);
-    }
-
-    for (; dim < DIMS; dim++)
-      if (sky.elems[dim] < cur.elems[dim])
-        lattice |= SHIFTS[dim];
-
-  } else if (DIMS >= 4) {
-    const Tuple<DIMS> __attribute__ ((aligned(32))) cur_value = cur;
-    const Tuple<DIMS> __attribute__ ((aligned(32))) sky_value = sky;
-
-    for (; dim + 4 <= DIMS; dim += 4) {
-      __m128 p_xmm = _mm_load_ps(cur_value.elems + dim);
-      __m128 sky_xmm = _mm_load_ps(sky_value.elems + dim);
-      __m128 comp_lt = _mm_cmp_ps(sky_xmm, p_xmm, 1);
-      uint32_t lt_mask = _mm_movemask_ps(comp_lt);
-      lattice = lattice | (lt_mask << dim);
-    }
-
-    for (; dim < DIMS; dim++)
-      if (sky.elems[dim] < cur.elems[dim])
-        lattice |= SHIFTS[dim];
-
-  } else {
-    for (dim = 0; dim < DIMS; dim++)
-      if (sky.elems[dim] < cur.elems[dim])
-        lattice |= SHIFTS[dim];
-  }
+  const uint32_t lattice = cmp_mask<_CMP_LT_OS>(sky, cur);
 
 #if COUNT_DT==1
   if ( lattice == ((1<<DIMS) - 1) )
@@ -253,68 +214,16 @@ inline int DominanceTest(const Tuple<DIMS> &left, const Tuple<DIMS> &right) {
  * One-way (optimized) dominance test.
  * No assumption for distinct value condition.
  */
-template<int DIMS>
+template< uint32_t DIMS >
 inline bool DominateLeft(const Tuple<DIMS> &left, const Tuple<DIMS> &right) {
 #if COUNT_DT==1
   __sync_fetch_and_add( &dt_count, 1 );
 #endif
-  uint32_t dim = 0;
-
-  if (DIMS >= 8) {
-    const Tuple<DIMS> __attribute__ ((aligned(32))) right_value = right;
-    const Tuple<DIMS> __attribute__ ((aligned(32))) left_value = left;
-
-    for (; dim + 8 <= DIMS; dim += 8) {
-      __m256 right_ymm = _mm256_load_ps(right_value.elems + dim);
-      __m256 left_ymm = _mm256_load_ps(left_value.elems + dim);
-      __m256 comp_lt = _mm256_cmp_ps(left_ymm, right_ymm, 2);
-      uint32_t lt_mask = _mm256_movemask_ps(comp_lt);
-      if (lt_mask != 255)
-        return false;
-    }
-
-    for (; dim + 4 <= DIMS; dim += 4) {
-      __m128 right_xmm = _mm_load_ps(right_value.elems + dim);
-      __m128 left_xmm = _mm_load_ps(left_value.elems + dim);
-      __m128 comp_lt = _mm_cmp_ps(left_xmm, right_xmm, 2);
-      uint32_t lt_mask = _mm_movemask_ps(comp_lt);
-      if (lt_mask != 15)
-        return false;
-    }
-
-    for (; dim < DIMS; dim++)
-      if (right.elems[dim] < left.elems[dim])
-        return false;
-
-  } else if (DIMS >= 4) {
-    const Tuple<DIMS> __attribute__ ((aligned(32))) right_value = right;
-    const Tuple<DIMS> __attribute__ ((aligned(32))) left_value = left;
-
-    for (; dim + 4 <= DIMS; dim += 4) {
-      __m128 right_xmm = _mm_load_ps(right_value.elems + dim);
-      __m128 left_xmm = _mm_load_ps(left_value.elems + dim);
-      __m128 comp_lt = _mm_cmp_ps(left_xmm, right_xmm, 2);
-      uint32_t lt_mask = _mm_movemask_ps(comp_lt);
-      if (lt_mask != 15)
-        return false;
-    }
-
-    for (; dim < DIMS; dim++)
-      if (right.elems[dim] < left.elems[dim])
-        return false;
-
-  } else {
-    for (dim = 0; dim < DIMS; dim++)
-      if (right.elems[dim] < left.elems[dim])
-        return false;
-  }
+  if (cmp_mask<_CMP_LE_OS>(left, right) != (1 << DIMS) - 1)
+    return false;
 
-  //test equality.
-  for (dim = 0; dim < DIMS; dim++)
-    if (right.elems[dim] != left.elems[dim])
-      return true;
-
-  return false; //points are equal.
+  //test equality: given <= everywhere, some < means not equal.
+  return cmp_mask<_CMP_LT_OS>(left, right) != 0;
 }
 
 /**
@@ -326,58 +235,7 @@ inline bool DominateLeftDVC(const Tuple<DIMS> &left, const Tuple<DIMS> &right) {
 #if COUNT_DT==1
   __sync_fetch_and_add( &dt_count, 1 );
 #endif
-  uint32_t dim = 0;
-
-  if (DIMS >= 8) {
-    const Tuple<DIMS> __attribute__ ((aligned(32))) right_value = right;
-    const Tuple<DIMS> __attribute__ ((aligned(32))) left_value = left;
-
-    for (; dim + 8 <= DIMS; dim += 8) {
-      __m256 right_ymm = _mm256_load_ps(right_value.elems + dim);
-      __m256 left_ymm = _mm256_load_ps(left_value.elems + dim);
-      __m256 comp_lt = _mm256_cmp_ps(left_ymm, right_ymm, 2);
-      uint32_t lt_mask = _mm256_movemask_ps(comp_lt);
-      if (lt_mask != 255)
-        return false;
-    }
-
-    for (; dim + 4 <= DIMS; dim += 4) {
-      __m128 right_xmm = _mm_load_ps(right_value.elems + dim);
-      __m128 left_xmm = _mm_load_ps(left_value.elems + dim);
-      __m128 comp_lt = _mm_cmp_ps(left_xmm, right_xmm, 2);
-      uint32_t lt_mask = _mm_movemask_ps(comp_lt);
-      if (lt_mask != 15)
-        return false;
-    }
-
-    for (; dim < DIMS; dim++)
-      if (right.elems[dim] < left.elems[dim])
-        return false;
-
-  } else if (DIMS >= 4) {
-    const Tuple<DIMS> __attribute__ ((aligned(32))) right_value = right;
-    const Tuple<DIMS> __attribute__ ((aligned(32))) left_value = left;
-
-    for (; dim + 4 <= DIMS; dim += 4) {
-      __m128 right_xmm = _mm_load_ps(right_value.elems + dim);
-      __m128 left_xmm = _mm_load_ps(left_value.elems + dim);
-      __m128 comp_lt = _mm_cmp_ps(left_xmm, right_xmm, 2);
-      uint32_t lt_mask = _mm_movemask_ps(comp_lt);
-      if (lt_mask != 15)
-        return false;
-    }
-
-    for (; dim < DIMS; dim++)
-      if (right.elems[dim] < left.elems[dim])
-        return false;
-
-  } else {
-    for (dim = 0; dim < DIMS; dim++)
-      if (right.elems[dim] < left.elems[dim])
-        return false;
-  }
-
-  return true;
+  return cmp_mask<_CMP_LE_OS>(left, right) == (1 << DIMS) - 1;
 }
 
 
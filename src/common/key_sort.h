@@ -0,0 +1,161 @@
+/**
+ * Sorting of PTuple arrays by their (partition, score, pid) keys only.
+ *
+ * Sorting the tuples themselves moves every value of every tuple each
+ * time that two of them are swapped: 64 bytes per tuple at d=10. Instead,
+ * the keys are extracted into compact 16-byte records that remember the
+ * position of their tuple, the records are sorted, and the tuples are
+ * then moved exactly once, by a gather into sorted order.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#ifndef KEY_SORT_H_
+#define KEY_SORT_H_
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#include <parallel/algorithm>
+#else
+#include <algorithm>
+#endif
+
+#include "common/common.h"
+
+/**
+ * The fields of a PTuple that its orderings compare, together with the
+ * position of the tuple in the array being sorted.
+ */
+struct SortKey {
+	uint32_t partition; /**< The partition of the tuple */
+	float score; /**< The score of the tuple */
+	uint32_t pid; /**< The unique id of the tuple */
+	uint32_t index; /**< The position of the tuple before sorting */
+};
+
+/** Orders keys as PTuple::operator<() orders tuples. */
+struct PartitionScoreLess {
+	bool operator()( const SortKey &lhs, const SortKey &rhs ) const {
+		if( lhs.partition != rhs.partition ) { return lhs.partition < rhs.partition; }
+		if( lhs.score != rhs.score ) { return lhs.score < rhs.score; }
+		return lhs.pid < rhs.pid;
+	}
+};
+
+/** Orders keys as PTuple::operator>() orders tuples. */
+struct PartitionScoreGreater {
+	bool operator()( const SortKey &lhs, const SortKey &rhs ) const {
+		if( lhs.partition != rhs.partition ) { return lhs.partition > rhs.partition; }
+		if( lhs.score != rhs.score ) { return lhs.score > rhs.score; }
+		return lhs.pid > rhs.pid;
+	}
+};
+
+/**
+ * Orders keys as STuple::operator>() orders tuples (by descending score),
+ * but breaks ties by ascending pid so that the order is deterministic.
+ */
+struct ScoreGreater {
+	bool operator()( const SortKey &lhs, const SortKey &rhs ) const {
+		return lhs.score > rhs.score || ( lhs.score == rhs.score && lhs.pid < rhs.pid );
+	}
+};
+
+/**
+ * Sorts an array of PTuples by sorting their keys and then gathering the
+ * tuples into sorted order.
+ * @param data The tuples to sort, in place.
+ * @param n The number of tuples.
+ * @param comp One of the key orderings above.
+ */
+template< uint32_t DIMS, typename V, typename Compare >
+void SortByKey( PTuple< DIMS, V > *data, const uint32_t n, const Compare comp ) {
+
+	std::vector< SortKey > keys( n );
+#pragma omp parallel for schedule( static )
+	for( uint32_t i = 0; i < n; ++i ) {
+		const SortKey key = { data[ i ].partition, data[ i ].score, data[ i ].pid, i };
+		keys[ i ] = key;
+	}
+
+#if defined(_OPENMP)
+	__gnu_parallel::sort( keys.begin(), keys.end(), comp );
+#else
+	std::sort( keys.begin(), keys.end(), comp );
+#endif
+
+	/* Gather into a scratch copy, then copy back, since data may be
+	 * memory that the caller does not own (see AdoptTuples()). */
+	PTuple< DIMS, V > *sorted = new PTuple< DIMS, V >[ n ];
+#pragma omp parallel for schedule( static )
+	for( uint32_t i = 0; i < n; ++i ) {
+		sorted[ i ] = data[ keys[ i ].index ];
+	}
+#pragma omp parallel for schedule( static )
+	for( uint32_t i = 0; i < n; ++i ) {
+		data[ i ] = sorted[ i ];
+	}
+	delete[] sorted;
+}
+
+/**
+ * Raises a threshold that is shared by all threads (e.g., the k'th best 
+ * score found so far) to at least value, without locking.
+ */
+inline void raise_threshold( uint32_t *threshold, const uint32_t value ) {
+	uint32_t current = __atomic_load_n( threshold, __ATOMIC_RELAXED );
+	while( current < value && !__atomic_compare_exchange_n( threshold, &current, value,
+		true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) { }
+}
+
+/**
+ * Selects the k first tuples in ScoreGreater order without sorting the
+ * whole array: every thread keeps a heap of the k best keys of its share 
+ * of the array, and only the (at most threads * k) survivors are sorted.
+ * @param data The tuples, which are left unchanged.
+ * @param n The number of tuples.
+ * @param k The number of tuples to select.
+ * @return The pids of the min( k, n ) best tuples, best first.
+ */
+template< uint32_t DIMS, typename V >
+std::vector< uint32_t > TopKByScore( const PTuple< DIMS, V > *data, const uint32_t n,
+	const uint32_t k ) {
+
+	const ScoreGreater comp;
+	std::vector< SortKey > survivors;
+	if( k == 0 ) { return std::vector< uint32_t >(); }
+
+#pragma omp parallel
+	{
+	/* A heap under comp has the worst of the best k so far at its front. */
+	std::vector< SortKey > heap;
+	heap.reserve( k + 1 );
+#pragma omp for schedule( static ) nowait
+	for( uint32_t i = 0; i < n; ++i ) {
+		const SortKey key = { data[ i ].partition, data[ i ].score, data[ i ].pid, i };
+		if( heap.size() == k && !comp( key, heap.front() ) ) { continue; }
+		heap.push_back( key );
+		std::push_heap( heap.begin(), heap.end(), comp );
+		if( heap.size() > k ) {
+			std::pop_heap( heap.begin(), heap.end(), comp );
+			heap.pop_back();
+		}
+	}
+#pragma omp critical
+	survivors.insert( survivors.end(), heap.begin(), heap.end() );
+	}
+
+	std::sort( survivors.begin(), survivors.end(), comp );
+	std::vector< uint32_t > pids;
+	for( uint32_t i = 0; i < k && i < survivors.size(); ++i ) {
+		pids.push_back( survivors[ i ].pid );
+	}
+	return pids;
+}
+
+#endif /* KEY_SORT_H_ */
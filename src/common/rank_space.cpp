@@ -0,0 +1,49 @@
+/**
+ * Implementation of the RankSpace transform.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#include "common/rank_space.h"
+
+#if defined(_OPENMP)
+#include <parallel/algorithm>
+#else
+#include <algorithm>
+#endif
+
+RankSpace::RankSpace( const Dataset &data ) : values_( data.num_dims() ) {
+
+	const uint32_t n = data.num_points();
+	for( uint32_t j = 0; j < data.num_dims(); ++j ) {
+		std::vector< float > &values = values_[ j ];
+		values.resize( n );
+		const ColumnView column = data.column( j );
+#pragma omp parallel for schedule( static )
+		for( uint32_t i = 0; i < n; ++i ) {
+			values[ i ] = column[ i ];
+		}
+
+#if defined(_OPENMP)
+		__gnu_parallel::sort( values.begin(), values.end() );
+#else
+		std::sort( values.begin(), values.end() );
+#endif
+		values.erase( std::unique( values.begin(), values.end() ), values.end() );
+		std::vector< float >( values ).swap( values );
+	}
+}
+
+uint32_t RankSpace::max_ranks() const {
+	uint32_t max = 0;
+	for( uint32_t j = 0; j < values_.size(); ++j ) {
+		if( values_[ j ].size() > max ) { max = values_[ j ].size(); }
+	}
+	return max;
+}
+
+uint32_t RankSpace::rank( const uint32_t j, const float x ) const {
+	return std::lower_bound( values_[ j ].begin(), values_[ j ].end(), x )
+		- values_[ j ].begin();
+}
@@ -0,0 +1,88 @@
+/**
+ * A per-dimension dense ranking of the values of a dataset.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#ifndef RANK_SPACE_H_
+#define RANK_SPACE_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "common/common.h"
+#include "common/dataset.h"
+
+/**
+ * Maps each value of a dataset to its dense rank among the distinct values
+ * of the same dimension. Dominance only depends on the order of values
+ * within each dimension, so replacing every value by its rank leaves all
+ * dominance relationships (and hence all top-k dominating scores) unchanged,
+ * while allowing the values to be stored in narrow integers (see rank_t).
+ */
+class RankSpace {
+
+public:
+
+	/**
+	 * Ranks the values of a dataset, sorting the dimensions in parallel.
+	 * @param data The dataset whose values should be ranked.
+	 */
+	explicit RankSpace( const Dataset &data );
+
+	uint32_t num_dims() const { return values_.size(); } /**< Returns d */
+
+	/** Returns the number of distinct values in dimension j. */
+	uint32_t num_ranks( const uint32_t j ) const { return values_[ j ].size(); }
+
+	/** Returns the largest number of distinct values in any dimension. */
+	uint32_t max_ranks() const;
+
+	/**
+	 * Returns the rank of x in dimension j, i.e., the number of distinct
+	 * values in dimension j that are less than x. For any value y of the
+	 * dataset, x <= y iff rank( j, x ) <= rank( j, y ), so arbitrary
+	 * thresholds (not only dataset values) can be ranked too.
+	 */
+	uint32_t rank( const uint32_t j, const float x ) const;
+
+	/** Returns the value of dimension j that has rank r. */
+	float value( const uint32_t j, const uint32_t r ) const { return values_[ j ][ r ]; }
+
+private:
+
+	std::vector< std::vector< float > > values_; /**< Sorted distinct values per dimension */
+};
+
+/**
+ * Converts a value of the dataset into the value type of a tuple: 
+ * the value itself for float tuples, or its rank for rank_t tuples.
+ * @param ranks The rank space of the dataset (unused for float).
+ */
+template< typename V >
+inline V ToSpace( const RankSpace *ranks, const uint32_t j, const float x );
+
+template<>
+inline float ToSpace< float >( const RankSpace *ranks, const uint32_t j, const float x ) {
+	return x;
+}
+
+template<>
+inline rank_t ToSpace< rank_t >( const RankSpace *ranks, const uint32_t j, const float x ) {
+	return ranks->rank( j, x );
+}
+
+/**
+ * Converts a value of a tuple back into the value of the dataset 
+ * that it represents (the inverse of ToSpace()).
+ */
+inline float FromSpace( const RankSpace *ranks, const uint32_t j, const float x ) {
+	return x;
+}
+
+inline float FromSpace( const RankSpace *ranks, const uint32_t j, const rank_t r ) {
+	return ranks->value( j, r );
+}
+
+#endif /* RANK_SPACE_H_ */
@@ -0,0 +1,343 @@
+/**
+ * A structure-of-arrays copy of a tuple array, in tiles of TILE_WIDTH
+ * points, and one-vs-many dominance tests that compare one point against
+ * a whole tile per instruction.
+ *
+ * The dominance tests in dt_avx2.h vectorize across the (2 to 10)
+ * dimensions of a single pair of points. Within a tile, all the values
+ * of one dimension are adjacent, so a test can instead broadcast each
+ * value of one point and vectorize across TILE_WIDTH points, producing
+ * a bitmask with one bit per point of the tile.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#ifndef SOA_TILES_H_
+#define SOA_TILES_H_
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/common.h"
+
+#if __AVX__ || __SSE4_1__
+#include <immintrin.h>
+#endif
+
+const uint32_t TILE_WIDTH = 8; /**< Points per tile (one ymm of floats) */
+
+/**
+ * TILE_WIDTH points, stored dimension by dimension.
+ */
+template< uint32_t DIMS, typename V = float >
+struct Tile {
+	V elems[ DIMS ][ TILE_WIDTH ] __attribute__ ((aligned(32))); /**< elems[ d ][ l ] is value d of point l */
+};
+
+/**
+ * A tiled, structure-of-arrays copy of an array of PTuples.
+ */
+template< uint32_t DIMS, typename V = float >
+class SoATiles {
+
+public:
+
+	SoATiles() : tiles_( NULL ), n_( 0 ), num_tiles_( 0 ) { }
+	~SoATiles() { free( tiles_ ); }
+
+	SoATiles( const SoATiles& ) = delete;
+	SoATiles& operator=( const SoATiles& ) = delete;
+
+	/**
+	 * (Re)builds the tiles from the current order of a tuple array.
+	 * @param data The tuples; point i goes to lane i % TILE_WIDTH of
+	 * tile i / TILE_WIDTH.
+	 * @param n The number of tuples.
+	 * @post The lanes of the last tile beyond n are zero-filled; use
+	 * valid_lanes() to mask them out.
+	 */
+	void Build( const PTuple< DIMS, V > *data, const uint32_t n ) {
+		free( tiles_ );
+		n_ = n;
+		num_tiles_ = ( n + TILE_WIDTH - 1 ) / TILE_WIDTH;
+		void *tiles = NULL;
+		if( posix_memalign( &tiles, 64, sizeof( Tile< DIMS, V > ) * ( num_tiles_ + 1 ) ) != 0 ) {
+			printf( "Can't allocate %u tiles\n", num_tiles_ );
+			exit( EXIT_FAILURE );
+		}
+		tiles_ = (Tile< DIMS, V >*) tiles;
+
+#pragma omp parallel for schedule( static )
+		for( uint32_t t = 0; t < num_tiles_; ++t ) {
+			Tile< DIMS, V > &tile = tiles_[ t ];
+			memset( &tile, 0, sizeof( tile ) );
+			const uint32_t first = t * TILE_WIDTH;
+			const uint32_t lanes = std::min( TILE_WIDTH, n - first );
+			for( uint32_t l = 0; l < lanes; ++l ) {
+				for( uint32_t d = 0; d < DIMS; ++d ) {
+					tile.elems[ d ][ l ] = data[ first + l ].elems[ d ];
+				}
+			}
+		}
+	}
+
+	uint32_t num_tiles() const { return num_tiles_; } /**< Returns the number of tiles */
+	const Tile< DIMS, V >& tile( const uint32_t t ) const { return tiles_[ t ]; } /**< Returns tile t */
+
+	/** Returns a bitmask of the lanes of tile t that hold a point. */
+	uint32_t valid_lanes( const uint32_t t ) const {
+		const uint32_t lanes = std::min( TILE_WIDTH, n_ - t * TILE_WIDTH );
+		return ( 1u << lanes ) - 1;
+	}
+
+private:
+
+	Tile< DIMS, V > *tiles_; /**< The tiles */
+	uint32_t n_; /**< The number of points */
+	uint32_t num_tiles_; /**< The number of tiles */
+};
+
+
+/**
+ * Scalar one-vs-many dominance test.
+ * @tparam POINT_LEFT If true, tests whether p dominates each point of t;
+ * otherwise, whether each point of t dominates p.
+ * @return A bitmask with bit l set iff the test holds for lane l.
+ */
+template< bool POINT_LEFT, uint32_t DIMS, typename V >
+inline uint32_t tile_dominance_scalar( const Tuple< DIMS, V > &p, const Tile< DIMS, V > &t ) {
+	uint32_t mask = 0;
+	for( uint32_t l = 0; l < TILE_WIDTH; ++l ) {
+		bool le = true, lt = false;
+		for( uint32_t d = 0; d < DIMS && le; ++d ) {
+			const V left = POINT_LEFT ? p.elems[ d ] : t.elems[ d ][ l ];
+			const V right = POINT_LEFT ? t.elems[ d ][ l ] : p.elems[ d ];
+			le = ( left <= right );
+			lt = lt || ( left < right );
+		}
+		if( le && lt ) { mask |= SHIFTS[ l ]; }
+	}
+	return mask;
+}
+
+/**
+ * One-vs-many dominance test on float tiles: one ymm compare (two xmm 
+ * compares with only SSE) per dimension covers the whole tile, and the 
+ * test stops as soon as no lane can hold. With AVX-512, the compares 
+ * write mask registers and each is masked by the lanes still in play.
+ * @tparam POINT_LEFT If true, tests whether p dominates each point of t;
+ * otherwise, whether each point of t dominates p.
+ * @return A bitmask with bit l set iff the test holds for lane l.
+ */
+template< bool POINT_LEFT, uint32_t DIMS >
+inline uint32_t tile_dominance( const Tuple< DIMS > &p, const Tile< DIMS > &t ) {
+#if __AVX512F__ && __AVX512VL__
+	__mmask8 le_all = 0xFF, lt_any = 0;
+#pragma GCC unroll 16
+	for( uint32_t d = 0; d < DIMS; ++d ) {
+		const __m256 p_ymm = _mm256_set1_ps( p.elems[ d ] );
+		const __m256 t_ymm = _mm256_load_ps( t.elems[ d ] );
+		const __m256 left = POINT_LEFT ? p_ymm : t_ymm;
+		const __m256 right = POINT_LEFT ? t_ymm : p_ymm;
+		le_all = _mm256_mask_cmp_ps_mask( le_all, left, right, _CMP_LE_OQ );
+		lt_any |= _mm256_mask_cmp_ps_mask( le_all, left, right, _CMP_LT_OQ );
+		if( le_all == 0 ) { return 0; }
+	}
+	return le_all & lt_any;
+#elif __AVX__
+	__m256 le_all = _mm256_castsi256_ps( _mm256_set1_epi32( -1 ) );
+	__m256 lt_any = _mm256_setzero_ps();
+#pragma GCC unroll 16
+	for( uint32_t d = 0; d < DIMS; ++d ) {
+		const __m256 p_ymm = _mm256_set1_ps( p.elems[ d ] );
+		const __m256 t_ymm = _mm256_load_ps( t.elems[ d ] );
+		const __m256 left = POINT_LEFT ? p_ymm : t_ymm;
+		const __m256 right = POINT_LEFT ? t_ymm : p_ymm;
+		le_all = _mm256_and_ps( le_all, _mm256_cmp_ps( left, right, _CMP_LE_OQ ) );
+		lt_any = _mm256_or_ps( lt_any, _mm256_cmp_ps( left, right, _CMP_LT_OQ ) );
+		if( _mm256_testz_ps( le_all, le_all ) ) { return 0; }
+	}
+	return _mm256_movemask_ps( _mm256_and_ps( le_all, lt_any ) );
+#elif __SSE4_1__
+	__m128 le_lo = _mm_castsi128_ps( _mm_set1_epi32( -1 ) ), le_hi = le_lo;
+	__m128 lt_lo = _mm_setzero_ps(), lt_hi = lt_lo;
+#pragma GCC unroll 16
+	for( uint32_t d = 0; d < DIMS; ++d ) {
+		const __m128 p_xmm = _mm_set1_ps( p.elems[ d ] );
+		const __m128 t_lo = _mm_load_ps( t.elems[ d ] );
+		const __m128 t_hi = _mm_load_ps( t.elems[ d ] + 4 );
+		le_lo = _mm_and_ps( le_lo, POINT_LEFT ? _mm_cmple_ps( p_xmm, t_lo ) : _mm_cmple_ps( t_lo, p_xmm ) );
+		le_hi = _mm_and_ps( le_hi, POINT_LEFT ? _mm_cmple_ps( p_xmm, t_hi ) : _mm_cmple_ps( t_hi, p_xmm ) );
+		lt_lo = _mm_or_ps( lt_lo, POINT_LEFT ? _mm_cmplt_ps( p_xmm, t_lo ) : _mm_cmplt_ps( t_lo, p_xmm ) );
+		lt_hi = _mm_or_ps( lt_hi, POINT_LEFT ? _mm_cmplt_ps( p_xmm, t_hi ) : _mm_cmplt_ps( t_hi, p_xmm ) );
+		if( _mm_movemask_ps( _mm_or_ps( le_lo, le_hi ) ) == 0 ) { return 0; }
+	}
+	return _mm_movemask_ps( _mm_and_ps( le_lo, lt_lo ) )
+		| ( _mm_movemask_ps( _mm_and_ps( le_hi, lt_hi ) ) << 4 );
+#else
+	return tile_dominance_scalar< POINT_LEFT >( p, t );
+#endif
+}
+
+/**
+ * One-vs-many dominance test on rank-space tiles: a tile's ranks of one
+ * dimension fill exactly one xmm register (compared into a mask register
+ * with AVX-512).
+ * @see tile_dominance( const Tuple< DIMS >&, const Tile< DIMS >& )
+ */
+template< bool POINT_LEFT, uint32_t DIMS >
+inline uint32_t tile_dominance( const Tuple< DIMS, rank_t > &p, const Tile< DIMS, rank_t > &t ) {
+#if __AVX512BW__ && __AVX512VL__
+	__mmask8 le_all = 0xFF, lt_any = 0;
+#pragma GCC unroll 16
+	for( uint32_t d = 0; d < DIMS; ++d ) {
+		const __m128i p_xmm = _mm_set1_epi16( p.elems[ d ] );
+		const __m128i t_xmm = _mm_load_si128( (const __m128i*) t.elems[ d ] );
+		const __m128i left = POINT_LEFT ? p_xmm : t_xmm;
+		const __m128i right = POINT_LEFT ? t_xmm : p_xmm;
+		le_all = _mm_mask_cmple_epu16_mask( le_all, left, right );
+		lt_any |= _mm_mask_cmplt_epu16_mask( le_all, left, right );
+		if( le_all == 0 ) { return 0; }
+	}
+	return le_all & lt_any;
+#elif __SSE4_1__
+	__m128i le_all = _mm_set1_epi16( -1 );
+	__m128i eq_all = le_all;
+#pragma GCC unroll 16
+	for( uint32_t d = 0; d < DIMS; ++d ) {
+		const __m128i p_xmm = _mm_set1_epi16( p.elems[ d ] );
+		const __m128i t_xmm = _mm_load_si128( (const __m128i*) t.elems[ d ] );
+		const __m128i right = POINT_LEFT ? t_xmm : p_xmm;
+		le_all = _mm_and_si128( le_all, _mm_cmpeq_epi16( _mm_max_epu16( p_xmm, t_xmm ), right ) );
+		eq_all = _mm_and_si128( eq_all, _mm_cmpeq_epi16( p_xmm, t_xmm ) );
+		if( _mm_testz_si128( le_all, le_all ) ) { return 0; }
+	}
+	return _mm_movemask_epi8( _mm_packs_epi16( _mm_andnot_si128( eq_all, le_all ),
+		_mm_setzero_si128() ) );
+#else
+	return tile_dominance_scalar< POINT_LEFT >( p, t );
+#endif
+}
+
+/**
+ * Computes the lattice mask of every point of tile t relative to p, as 
+ * DT_bitmap_dvc( point, p ) does for one point: bit d is set iff p is at 
+ * least as good as the point in dimension d. The masks are built in 
+ * vector lanes, one lane per point, by OR-ing in bit d of each 
+ * dimension's compare, and written out with one or two stores.
+ * @param masks Where to write the TILE_WIDTH masks, in lane order.
+ */
+template< uint32_t DIMS >
+inline void tile_lattice( const Tuple< DIMS > &p, const Tile< DIMS > &t, uint32_t *masks ) {
+#if __AVX__
+	__m256 lattice = _mm256_setzero_ps();
+#pragma GCC unroll 16
+	for( uint32_t d = 0; d < DIMS; ++d ) {
+		const __m256 le = _mm256_cmp_ps( _mm256_set1_ps( p.elems[ d ] ),
+			_mm256_load_ps( t.elems[ d ] ), _CMP_LE_OQ );
+		lattice = _mm256_or_ps( lattice,
+			_mm256_and_ps( le, _mm256_castsi256_ps( _mm256_set1_epi32( SHIFTS[ d ] ) ) ) );
+	}
+	_mm256_storeu_ps( (float*) masks, lattice );
+#elif __SSE4_1__
+	__m128 lattice_lo = _mm_setzero_ps(), lattice_hi = lattice_lo;
+#pragma GCC unroll 16
+	for( uint32_t d = 0; d < DIMS; ++d ) {
+		const __m128 p_xmm = _mm_set1_ps( p.elems[ d ] );
+		const __m128 bit = _mm_castsi128_ps( _mm_set1_epi32( SHIFTS[ d ] ) );
+		lattice_lo = _mm_or_ps( lattice_lo,
+			_mm_and_ps( _mm_cmple_ps( p_xmm, _mm_load_ps( t.elems[ d ] ) ), bit ) );
+		lattice_hi = _mm_or_ps( lattice_hi,
+			_mm_and_ps( _mm_cmple_ps( p_xmm, _mm_load_ps( t.elems[ d ] + 4 ) ), bit ) );
+	}
+	_mm_storeu_ps( (float*) masks, lattice_lo );
+	_mm_storeu_ps( (float*) ( masks + 4 ), lattice_hi );
+#else
+	for( uint32_t l = 0; l < TILE_WIDTH; ++l ) {
+		uint32_t lattice = 0;
+		for( uint32_t d = 0; d < DIMS; ++d ) {
+			if( p.elems[ d ] <= t.elems[ d ][ l ] ) { lattice |= SHIFTS[ d ]; }
+		}
+		masks[ l ] = lattice;
+	}
+#endif
+}
+
+/**
+ * Computes the lattice masks of a rank-space tile: the masks are built 
+ * in 16-bit lanes (DIMS <= 16) and widened to 32 bits for the stores.
+ * @see tile_lattice( const Tuple< DIMS >&, const Tile< DIMS >&, uint32_t* )
+ */
+template< uint32_t DIMS >
+inline void tile_lattice( const Tuple< DIMS, rank_t > &p, const Tile< DIMS, rank_t > &t,
+	uint32_t *masks ) {
+#if __SSE4_1__
+	__m128i lattice = _mm_setzero_si128();
+#pragma GCC unroll 16
+	for( uint32_t d = 0; d < DIMS; ++d ) {
+		const __m128i t_xmm = _mm_load_si128( (const __m128i*) t.elems[ d ] );
+		const __m128i le = _mm_cmpeq_epi16( _mm_max_epu16( _mm_set1_epi16( p.elems[ d ] ), t_xmm ), t_xmm );
+		lattice = _mm_or_si128( lattice, _mm_and_si128( le, _mm_set1_epi16( SHIFTS[ d ] ) ) );
+	}
+#if __AVX2__
+	_mm256_storeu_si256( (__m256i*) masks, _mm256_cvtepu16_epi32( lattice ) );
+#else
+	_mm_storeu_si128( (__m128i*) masks, _mm_cvtepu16_epi32( lattice ) );
+	_mm_storeu_si128( (__m128i*) ( masks + 4 ), _mm_cvtepu16_epi32( _mm_srli_si128( lattice, 8 ) ) );
+#endif
+#else
+	for( uint32_t l = 0; l < TILE_WIDTH; ++l ) {
+		uint32_t lattice = 0;
+		for( uint32_t d = 0; d < DIMS; ++d ) {
+			if( p.elems[ d ] <= t.elems[ d ][ l ] ) { lattice |= SHIFTS[ d ]; }
+		}
+		masks[ l ] = lattice;
+	}
+#endif
+}
+
+/**
+ * Writes the lattice masks of all the points of a tiled block relative
+ * to p, one uint32_t per point, tile by tile.
+ * @param masks The output, which must have room for whole tiles 
+ * (num_tiles() * TILE_WIDTH masks); the masks of the lanes beyond the 
+ * last point are garbage.
+ */
+template< uint32_t DIMS, typename V >
+inline void LatticeMasks( const Tuple< DIMS, V > &p, const SoATiles< DIMS, V > &points,
+	uint32_t *masks ) {
+#if COUNT_DT==1
+  __sync_fetch_and_add( &dt_count, points.num_tiles() * TILE_WIDTH );
+#endif
+#pragma omp parallel for schedule( static )
+	for( uint32_t t = 0; t < points.num_tiles(); ++t ) {
+		tile_lattice< DIMS >( p, points.tile( t ), masks + t * TILE_WIDTH );
+	}
+}
+
+/**
+ * Returns a bitmask of the points of tile t that are dominated by p.
+ */
+template< uint32_t DIMS, typename V >
+inline uint32_t DominatesMask( const Tuple< DIMS, V > &p, const Tile< DIMS, V > &t ) {
+#if COUNT_DT==1
+  __sync_fetch_and_add( &dt_count, TILE_WIDTH );
+#endif
+	return tile_dominance< true, DIMS >( p, t );
+}
+
+/**
+ * Returns a bitmask of the points of tile t that dominate p.
+ */
+template< uint32_t DIMS, typename V >
+inline uint32_t DominatedByMask( const Tuple< DIMS, V > &p, const Tile< DIMS, V > &t ) {
+#if COUNT_DT==1
+  __sync_fetch_and_add( &dt_count, TILE_WIDTH );
+#endif
+	return tile_dominance< false, DIMS >( p, t );
+}
+
+#endif /* SOA_TILES_H_ */
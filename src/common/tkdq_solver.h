@@ -12,6 +12,8 @@
 #include <stdint.h>
 #include <vector>
 
+#include "common/dataset.h"
+
 /**
  * An abstract class defining the basic behaviour 
  * of an algorithm that can solve top-k dominating 
@@ -26,13 +28,45 @@ public:
 
 	/**
 	 * Initializes the TKDQ solver with a new input dataset.
-	 * @param data A flat array of floats corresponding to the input data 
-	 * over which the top-k dominating query should be answered.
+	 * @param data The input dataset over which the top-k dominating query 
+	 * should be answered.
 	 * @note Operations in this function should be restricted to those that 
 	 * are unfair to time; this is meant to provide a fair starting point for 
 	 * all algorithms, even if they use alternate data structures.
 	 */
-  virtual void Init( float** data ) = 0;
+  virtual void Init( const Dataset &data ) = 0;
+
+	/**
+	 * Initializes the TKDQ solver with a new input dataset, adopting the 
+	 * memory of the dataset in place rather than copying it, if its rows 
+	 * are already laid out as the tuples of the solver (i.e., have a row 
+	 * stride of TupleRowStride( d )). Otherwise, behaves as Init().
+	 * @param data The input dataset. If adopted, it must outlive the solver 
+	 * and its contents are consumed: Execute() may reorder and overwrite them.
+	 */
+  virtual void InitInPlace( Dataset &data ) { Init( data ); }
+
+	/**
+	 * Initializes the TKDQ solver incrementally while the dataset is still 
+	 * being loaded (see RowBlockConsumer): BeginInit() is called once the 
+	 * size of the dataset is known, InitBlock() for each block of rows as 
+	 * soon as it has been parsed, and FinishInit() once all rows are 
+	 * available. Solvers may use the blocks to overlap not only their 
+	 * initialization but also the first, per-point phase of Execute() 
+	 * with parsing, since the end-to-end time is then measured.
+	 * By default, all work is deferred to FinishInit(), which calls Init().
+	 * @param data The input dataset, of which only rows [begin, end) are 
+	 * guaranteed to be populated.
+	 * @param begin The first row of the block.
+	 * @param end One past the last row of the block.
+	 * @note Calls to InitBlock() may be concurrent (their blocks are 
+	 * disjoint) and may arrive in any order, so any shared setup belongs 
+	 * in BeginInit().
+	 */
+  virtual void InitBlock( const Dataset &data, const uint32_t begin, 
+  	const uint32_t end ) { }
+  virtual void BeginInit( const Dataset &data ) { } /**< @see InitBlock() */
+  virtual void FinishInit( const Dataset &data ) { Init( data ); } /**< @see InitBlock() */
   
   /**
    * Executes a top-k dominating query on the dataset with which the TKDQ 
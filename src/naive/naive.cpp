@@ -6,8 +6,11 @@
  */
 
 #include <iostream>
+#include <functional>
+#include <queue>
 
 #include "naive.h"
+#include "util/cache_size.h"
 
 template class Naive< 2 >;
 template class Naive< 3 >;
@@ -18,63 +21,210 @@ template class Naive< 7 >;
 template class Naive< 8 >;
 template class Naive< 9 >;
 template class Naive< 10 >;
+template class Naive< 2, rank_t >;
+template class Naive< 3, rank_t >;
+template class Naive< 4, rank_t >;
+template class Naive< 5, rank_t >;
+template class Naive< 6, rank_t >;
+template class Naive< 7, rank_t >;
+template class Naive< 8, rank_t >;
+template class Naive< 9, rank_t >;
+template class Naive< 10, rank_t >;
 
 
-template< uint32_t dims >
-void Naive< dims >::Init( float** data ) {
+template< uint32_t dims, typename V >
+void Naive< dims, V >::Init( const Dataset &data ) {
 
 	/* Allocate space. */
-	data_ = new STuple< dims >[n_];
+	data_ = new PTuple< dims, V >[n_];
+	owns_data_ = true;
 	
-	/* Copy data from float array into tuple array and record
-	 * point ids. */
+	/* Copy (or rank-transform) data from the dataset into tuple array 
+	 * and record point ids. */
 #pragma omp parallel for
 	for ( uint32_t i = 0; i < n_; ++i ) {
 		data_[ i ].pid = i;
 		data_[ i ].score = 0;
-		memcpy( data_[ i ].elems, data[ i ], sizeof( float ) * dims );
+		data_[ i ].partition = 0;
+		const float *row = data.row( i );
+		for( uint32_t d = 0; d < dims; ++d ) {
+			data_[ i ].elems[ d ] = ToSpace< V >( ranks_, d, row[ d ] );
+		}
 	}
 }
 
 
-template< uint32_t dims >
-std::vector< uint32_t > Naive< dims >::Execute( const uint32_t k ) {
+template< uint32_t dims, typename V >
+void Naive< dims, V >::InitInPlace( Dataset &data ) {
+
+	/* Fall back to copying if the rows are not laid out as tuples. */
+	data_ = AdoptTuples< dims, V >( data );
+	if( data_ == NULL ) { Init( data ); return; }
+	owns_data_ = false;
 	
-	/* First, calculate Manhattan norm for every point. */
+	/* Only the point ids and scores need to be written. */
 #pragma omp parallel for
-	for( uint32_t i = 0; i < n_; ++i ) {
+	for ( uint32_t i = 0; i < n_; ++i ) {
+		data_[ i ].pid = i;
+		data_[ i ].score = 0;
+		data_[ i ].partition = 0;
+	}
+}
+
+
+template< uint32_t dims, typename V >
+void Naive< dims, V >::BeginInit( const Dataset &data ) {
+	data_ = new PTuple< dims, V >[n_];
+	owns_data_ = true;
+	prescored_ = true;
+}
+
+
+template< uint32_t dims, typename V >
+void Naive< dims, V >::InitBlock( const Dataset &data, const uint32_t begin, 
+	const uint32_t end ) {
+
+	/* Copy the block, computing Manhattan norms while it is in cache. */
+	for ( uint32_t i = begin; i < end; ++i ) {
+		data_[ i ].pid = i;
+		data_[ i ].score = 0;
+		data_[ i ].partition = 0;
+		const float *row = data.row( i );
 		for( uint32_t d = 0; d < dims; ++d ) {
-			data_[ i ].score += data_[ i ].elems[ d ];
+			data_[ i ].elems[ d ] = ToSpace< V >( ranks_, d, row[ d ] );
+			data_[ i ].score += FromSpace( ranks_, d, data_[ i ].elems[ d ] );
 		}
 	}
-	
-	/* Next, sort the data by descending manhattan norm. */
-	std::sort( data_, data_ + n_ );
-	
+}
 
-	/* Then, compute the top-k dominating score for every point. */\
-#pragma omp parallel for schedule( dynamic, 128 )
-	for( uint32_t i = 0; i < n_; ++i ) {
-		data_[ i ].score = 0;
-		uint32_t num_dominated_by = 0;
-		for( uint32_t j = 0; j < i; ++j ) {
-			if( DominateLeft< dims >( data_[ j ], data_[ i ] ) ) {
-				if( ++num_dominated_by >= k ) { break; }
+
+template< uint32_t dims, typename V >
+void Naive< dims, V >::FinishInit( const Dataset &data ) {
+	if( data_ == NULL ) { Init( data ); }
+}
+
+
+/**
+ * Rounds a number of points down to a whole number of NAIVE_BLOCK_ALIGN 
+ * points (but at least one).
+ */
+inline uint32_t round_block( const uint32_t points ) {
+	return std::max( NAIVE_BLOCK_ALIGN, points / NAIVE_BLOCK_ALIGN * NAIVE_BLOCK_ALIGN );
+}
+
+
+template< uint32_t dims, typename V > template< typename Block >
+void Naive< dims, V >::score_points( const Block &points, const uint32_t k ) {
+
+	/* A comparator block fills half of L1d and a candidate block half of 
+	 * L2, but there are at least NAIVE_BLOCKS_PER_THREAD candidate blocks 
+	 * per thread, for load balance. */
+	const uint32_t bytes = sizeof( PTuple< dims, V > );
+	const uint32_t comparators = round_block( L1DataCacheSize() / 2 / bytes );
+	const uint32_t candidates = round_block( std::min( L2CacheSize() / 2 / bytes,
+		n_ / ( NAIVE_BLOCKS_PER_THREAD * t_ ) ) );
+
+	/* A lower bound on the k'th best score: the highest k'th best score 
+	 * that any thread has found so far. A point can only dominate points 
+	 * after it, so point i cannot score more than n - i - 1; a point whose 
+	 * bound falls below the threshold cannot make the top-k (not even on 
+	 * a tie) and is pruned. */
+	uint32_t threshold = 0;
+
+#pragma omp parallel
+	{
+	std::vector< uint32_t > dominators( candidates ), scores( candidates );
+	std::priority_queue< uint32_t, std::vector< uint32_t >, std::greater< uint32_t > > best;
+#pragma omp for schedule( dynamic )
+	for( uint32_t ib = 0; ib < n_; ib += candidates ) {
+		const uint32_t ie = std::min( n_, ib + candidates );
+		std::fill( dominators.begin(), dominators.end(), 0 );
+		std::fill( scores.begin(), scores.end(), 0 );
+
+		/* Prune the candidates that cannot beat the threshold even if they 
+		 * dominate every later point. */
+		uint32_t unpruned = ie - ib;
+		const uint32_t initial = __atomic_load_n( &threshold, __ATOMIC_RELAXED );
+		for( uint32_t i = ib; i < ie && k > 0; ++i ) {
+			if( n_ - i - 1 < initial ) {
+				dominators[ i - ib ] = k;
+				--unpruned;
+			}
+		}
+
+		/* Count the dominators of each candidate i among [0, i), one block of 
+		 * comparators at a time, until it has k of them. */
+		for( uint32_t jb = 0; jb < ie && unpruned > 0; jb += comparators ) {
+			const uint32_t je = std::min( ie, jb + comparators );
+			for( uint32_t i = std::max( ib, jb + 1 ); i < ie; ++i ) {
+				uint32_t &dom = dominators[ i - ib ];
+				if( dom >= k ) { continue; }
+				dom += count_dominators( data_[ i ], points, jb, std::min( je, i ), k - dom );
+				unpruned -= ( dom >= k );
 			}
 		}
-		if( num_dominated_by < k ) {
-			for( uint32_t j = i + 1; j < n_; ++j ) {
-				if( DominateLeft< dims >( data_[ i ], data_[ j ] ) ) { ++data_[ i ].score; }
+
+		/* Then count the points among [i + 1, n) that the unpruned ones dominate, 
+		 * abandoning each as soon as the rest of the scan cannot lift it to 
+		 * the threshold. */
+		for( uint32_t jb = ib; jb < n_ && unpruned > 0; jb += comparators ) {
+			const uint32_t je = std::min( n_, jb + comparators );
+			const uint32_t current = __atomic_load_n( &threshold, __ATOMIC_RELAXED );
+			for( uint32_t i = ib; i < ie && i + 1 < je; ++i ) {
+				if( dominators[ i - ib ] >= k ) { continue; }
+				const uint32_t begin = std::max( jb, i + 1 );
+				if( scores[ i - ib ] + ( n_ - begin ) < current ) {
+					dominators[ i - ib ] = k;
+					--unpruned;
+					continue;
+				}
+				scores[ i - ib ] += count_dominated( data_[ i ], points, begin, je );
 			}
-		} 
+		}
+
+		/* Publish the scores, and the thread's k'th best so far as the threshold. */
+		for( uint32_t i = ib; i < ie; ++i ) {
+			data_[ i ].score = ( dominators[ i - ib ] < k ? scores[ i - ib ] : 0 );
+			if( dominators[ i - ib ] < k ) {
+				best.push( scores[ i - ib ] );
+				if( best.size() > k ) { best.pop(); }
+			}
+		}
+		if( k > 0 && best.size() == k ) { raise_threshold( &threshold, best.top() ); }
 	}
+	}
+}
+
+
+template< uint32_t dims, typename V >
+std::vector< uint32_t > Naive< dims, V >::Execute( const uint32_t requested_k ) {
 
-	/* Re-sort the data, this time by top-k dominating score. */
-	std::sort( data_, data_ + n_, std::greater< STuple< dims > >() );
+	/* No more than all n_ points can be returned, and the pruning bounds 
+	 * assume that k of them exist. */
+	const uint32_t k = std::min( requested_k, n_ );
+
+	/* First, calculate Manhattan norm for every point (unless InitBlock() did). */
+	if( !prescored_ ) {
+#pragma omp parallel for
+		for( uint32_t i = 0; i < n_; ++i ) {
+			for( uint32_t d = 0; d < dims; ++d ) {
+				data_[ i ].score += FromSpace( ranks_, d, data_[ i ].elems[ d ] );
+			}
+		}
+	}
+	
+	/* Next, sort the data by descending manhattan norm. */
+	SortByKey( data_, n_, PartitionScoreLess() );
 	
-	/* Copy the top-k points from the list into the output array and return it. */
-	for( uint32_t i = 0; i < k; ++i ) {
-		result_.push_back( data_[ i ].pid );
+
+	/* Then, compute the top-k dominating score for every point. */
+	if( soa_ ) {
+		tiles_.Build( data_, n_ );
+		score_points( tiles_, k );
 	}
+	else { score_points( data_, k ); }
+
+	/* Select the k points with the best top-k dominating scores. */
+	result_ = TopKByScore( data_, n_, k );
 	return result_;
 }
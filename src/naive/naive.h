@@ -22,46 +22,78 @@
 #endif
 
 #include "common/common.h" //was common2.h
+#include "common/key_sort.h"
+#include "common/dominance_count.h"
+#include "common/rank_space.h"
+#include "common/soa_tiles.h"
 #include "common/tkdq_solver.h"
 //#include "util/papi_counting.h"
 
+const uint32_t NAIVE_BLOCK_ALIGN = 64; /**< Block sizes are multiples of this many points */
+const uint32_t NAIVE_BLOCKS_PER_THREAD = 8; /**< The fewest candidate blocks per thread */
+
 
 /**
  * A class for executing our Naive algorithm to compute top-k dominating queries.
  * 
  * @tparam DIMS The number of dimensions in the input dataset.
+ * @tparam V The type of the tuple values: float, or rank_t to run on 
+ * the dataset transformed into rank space (see RankSpace).
  */
-template< uint32_t DIMS >
+template< uint32_t DIMS, typename V = float >
 class Naive: public TKDQ_Solver {
 
 public:
 	
 	/**
 	 * Constructs a new instance of a Naive TKDQ solver
+	 * @param ranks The rank space of the dataset; required iff V is rank_t.
+	 * @param soa True if dominance tests should be run one point against 
+	 * a tile of points at a time, on a structure-of-arrays copy (SoATiles).
 	 * @post Creates a new Naive TKDQ solver instance.
 	 */
-  Naive(uint32_t threads, uint32_t n, float** data ) :
-      t_(threads), n_(n) {
+  Naive(uint32_t threads, uint32_t n, const Dataset &data, 
+      const RankSpace *ranks = NULL, const bool soa = false ) :
+      t_(threads), n_(n), ranks_(ranks), soa_(soa) {
 
     omp_set_num_threads(threads);
     result_.reserve(1024);
     data_ = NULL;
+    owns_data_ = false;
+    prescored_ = false;
   }
 
 	/**
 	 * Destructor for the Naive TKDQ solver
 	 * @post Destroys the Naive TKDQ solver instance.
 	 */
-  ~Naive() { }
+  ~Naive() { if( owns_data_ ) { delete[] data_; } }
   
   /**
    * Initializes the TKDQ solver with a new dataset.
-   * @param data The flat array of floats corresponding to the 
-   * input data.
+   * @param data The input dataset.
    * @post Populates the internal data structures of this Naive 
    * TKDQ solver to reflect the dataset provided.
    */
-  void Init( float** data );
+  void Init( const Dataset &data );
+
+  /**
+   * Initializes the TKDQ solver by adopting the dataset in place, if 
+   * possible, rather than copying it.
+   * @param data The input dataset, which is consumed if adopted.
+   * @post As Init(), but without allocating or copying tuples if the 
+   * rows of data are laid out as PTuple< DIMS >.
+   */
+  void InitInPlace( Dataset &data );
+
+  /**
+   * Initializes the TKDQ solver from a block of a dataset that is still 
+   * being loaded, also computing the Manhattan norms of its points while the block is in cache.
+   * @see TKDQ_Solver::InitBlock()
+   */
+  void BeginInit( const Dataset &data );
+  void InitBlock( const Dataset &data, const uint32_t begin, const uint32_t end );
+  void FinishInit( const Dataset &data );
 
 	std::vector< uint32_t > Execute( const uint32_t k );
 
@@ -71,9 +103,31 @@ protected:
   // Data members:
   uint32_t n_; /**< The number of points in the dataset. */
   const uint32_t t_; /**< The number of threads with which the solution should be obtained. */
-  STuple<DIMS> *data_; /**< The internal representation of the dataset. */
+  PTuple< DIMS, V > *data_; /**< The internal representation of the dataset. */
+  const RankSpace *ranks_; /**< The rank space of the dataset, if V is rank_t */
+  bool owns_data_; /**< True if data_ was allocated (rather than adopted) */
+  bool prescored_; /**< True if InitBlock() computes the norms */
+  const bool soa_; /**< True if the tiled (SoA) kernels should be used */
+  SoATiles< DIMS, V > tiles_; /**< Tiled copy of data_ in sorted order, if soa_ */
   std::vector< uint32_t > result_; /**< The vector that will contain the result point ids */
 
+private:
+
+  /**
+   * Computes the top-k dominating score of every point that is dominated 
+   * by fewer than k others (and zero for the rest). Each thread takes a 
+   * block of candidate points (sized to stay in L2) at a time and scans 
+   * the points against which they are compared block by block (sized to 
+   * stay in L1d), accumulating the candidates' counts privately. Points 
+   * that provably cannot reach the current k'th best score are skipped 
+   * or abandoned (and scored zero).
+   * @param points The block on which dominance is counted (see 
+   * count_dominated()): data_ itself, or tiles_ built from it.
+   * @pre data_ is sorted by ascending Manhattan norm, so only earlier 
+   * points can dominate a point and only later ones can be dominated by it.
+   */
+  template< typename Block >
+  void score_points( const Block &points, const uint32_t k );
 };
 
 #endif /* NAIVE_H_ */
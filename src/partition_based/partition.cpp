@@ -22,7 +22,7 @@ template class Partition< 10 >;
 template < uint32_t dims >
 Partition< dims >
 ::Partition( const int32_t n ) 
-	: upper_bound_score( n - 1 ) {
+	: begin( 0 ), end( n ), upper_bound_score( n - 1 ) {
 	
 	for( uint32_t d = 0; d < dims; ++d ) {
 		lower_bound_coord.elems[ d ] = 0;
@@ -34,7 +34,7 @@ template < uint32_t dims >
 Partition< dims >
 ::Partition( Tuple< dims > lower_corner, Tuple< dims > upper_corner
 	, const int32_t n ) 
-	: upper_bound_score( n - 1 ) {
+	: begin( 0 ), end( n ), upper_bound_score( n - 1 ) {
 	
 	for( uint32_t d = 0; d < dims; ++d ) {
 		lower_bound_coord.elems[ d ] = lower_corner.elems[ d ];
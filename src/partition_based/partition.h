@@ -31,7 +31,7 @@ public:
 	 * one larger than the maximum dominance score a point can 
 	 * obtain).
 	 * @post Constructs a new Partition object corresponding to the 
-	 * entire data space.
+	 * entire data space, holding positions [0, n) of the permutation.
 	 */
 	Partition( const int32_t n );
 
@@ -46,9 +46,14 @@ public:
 	 * one larger than the maximum dominance score a point can 
 	 * obtain).
 	 * @post Constructs a new Partition object corresponding to the 
-	 * given data space.
+	 * given data space, holding positions [0, n) of the permutation.
 	 */
 	Partition( Tuple< dims > lower_corner, Tuple< dims > upper_corner, const int32_t n );
+	
+	/**
+	 * Returns the number of points in the partition.
+	 */
+	uint32_t size() const { return end - begin; }
   
   /**
    * Appends Partition p to the output stream out.
@@ -60,10 +65,7 @@ public:
   friend std::ostream& operator<<( std::ostream &out, const Partition< dims > &p ) { 
   	out << "(" << p.upper_bound_score << ") ";
 		out << p.lower_bound_coord << "<->" << p.upper_bound_coord;
-		out << ":";
-		for( uint32_t i = 0; i < p.points.size(); ++i ) {
-			out << " " << p.points[ i ];
-		}
+		out << ": [" << p.begin << ", " << p.end << ")";
 		return out;
 	}  
 	
@@ -72,7 +74,8 @@ public:
 	//data members -- currently public
 	Tuple< dims > lower_bound_coord;
 	Tuple< dims > upper_bound_coord;
-	std::vector< uint32_t > points;
+	uint32_t begin; /**< The first position of the partition's points in the permutation */
+	uint32_t end; /**< One past the last position of the partition's points */
 	int32_t upper_bound_score;
 };
 
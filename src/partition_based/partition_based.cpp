@@ -16,7 +16,6 @@
 #include "common/common.h"
 
 #include <vector>
-#include <unordered_map>
 
 /* Template instantiations.*/
 template class PartitionBased< 2 >;
@@ -28,28 +27,93 @@ template class PartitionBased< 7 >;
 template class PartitionBased< 8 >;
 template class PartitionBased< 9 >; 
 template class PartitionBased< 10 >;
+template class PartitionBased< 2, rank_t >;
+template class PartitionBased< 3, rank_t >;
+template class PartitionBased< 4, rank_t >;
+template class PartitionBased< 5, rank_t >;
+template class PartitionBased< 6, rank_t >;
+template class PartitionBased< 7, rank_t >;
+template class PartitionBased< 8, rank_t >;
+template class PartitionBased< 9, rank_t >;
+template class PartitionBased< 10, rank_t >;
 
 
 
 const auto& maxAnswer = std::greater< answer >(); /**< Alias for heap's comparator */
 
-template< uint32_t dims >
-void PartitionBased< dims >
-::Init( float** data ) {
+template< uint32_t dims, typename V >
+void PartitionBased< dims, V >
+::Init( const Dataset &data ) {
 
-	data_ = new PTuple< dims >[ n_ ];
+	data_ = new PTuple< dims, V >[ n_ ];
+	owns_data_ = true;
 	
 #pragma omp parallel for
 	for ( uint32_t i = 0; i < n_; ++i ) {
 		data_[ i ].pid = i;
-		memcpy( data_[ i ].elems, data[ i ], sizeof( float ) * dims );
+		const float *row = data.row( i );
+		for( uint32_t d = 0; d < dims; ++d ) {
+			data_[ i ].elems[ d ] = ToSpace< V >( ranks_, d, row[ d ] );
+		}
 		data_[ i ].score = 0;
 		data_[ i ].partition = 0;
 	}
 }
 
+template< uint32_t dims, typename V >
+void PartitionBased< dims, V >
+::InitInPlace( Dataset &data ) {
+
+	data_ = AdoptTuples< dims, V >( data );
+	if( data_ == NULL ) { Init( data ); return; }
+	owns_data_ = false;
+	
+#pragma omp parallel for
+	for ( uint32_t i = 0; i < n_; ++i ) {
+		data_[ i ].pid = i;
+		data_[ i ].score = 0;
+		data_[ i ].partition = 0;
+	}
+}
+
+template< uint32_t dims, typename V >
+void PartitionBased< dims, V >::BeginInit( const Dataset &data ) {
+	data_ = new PTuple< dims, V >[n_];
+	owns_data_ = true;
+	prescored_ = true;
+}
+
+
+template< uint32_t dims, typename V >
+void PartitionBased< dims, V >::InitBlock( const Dataset &data, const uint32_t begin, 
+	const uint32_t end ) {
+
+	/* Copy the block, computing the volumes of dominance areas while it is in cache. */
+	for ( uint32_t i = begin; i < end; ++i ) {
+		data_[ i ].pid = i;
+		data_[ i ].score = 0;
+		data_[ i ].partition = 0;
+		const float *row = data.row( i );
+		for( uint32_t d = 0; d < dims; ++d ) {
+			data_[ i ].elems[ d ] = ToSpace< V >( ranks_, d, row[ d ] );
+		}
+		float volume = 1;
+		for( uint32_t d = 0; d < dims; ++d ) {
+			volume *= ( 1 - FromSpace( ranks_, d, data_[ i ].elems[ d ] ) );
+		}
+		data_[ i ].score = volume;
+	}
+}
+
+
+template< uint32_t dims, typename V >
+void PartitionBased< dims, V >::FinishInit( const Dataset &data ) {
+	if( data_ == NULL ) { Init( data ); }
+}
+
+
 template < uint32_t dims >
-void inline generate_coordinates( Partition< dims > &original, Partition< dims > &result, 
+void inline generate_coordinates( const Partition< dims > &original, Partition< dims > &result, 
 	const uint32_t bitmask, Tuple< dims > &pivot ) {
 	
 	for( uint32_t d = 0; d < dims; ++d ) {
@@ -73,7 +137,26 @@ void inline generate_coordinates( Partition< dims > &original, Partition< dims >
 }
 
 
-template< uint32_t dims > uint32_t inline PartitionBased< dims >
+/**
+ * Counts the points at positions [begin, end) of a permutation (except the 
+ * pivot) by lattice mask, and lists the distinct masks in order of first 
+ * appearance.
+ * @param counts Zero for every mask on entry; the count of each on exit.
+ * @param touched Empty on entry; the distinct masks on exit.
+ */
+void inline count_masks( const uint32_t *order, const uint32_t begin, const uint32_t end, 
+	const uint32_t pivot, const uint32_t *masks, uint32_t *counts, 
+	std::vector< uint32_t > &touched ) {
+	
+	for( uint32_t j = begin; j < end; ++j ) {
+		if( order[ j ] == pivot ) { continue; }
+		const uint32_t p = masks[ order[ j ] ];
+		if( counts[ p ]++ == 0 ) { touched.push_back( p ); }
+	}
+}
+
+
+template< uint32_t dims, typename V > uint32_t inline PartitionBased< dims, V >
 ::select_pivot( Partitioning< dims > *partitions, std::vector< uint32_t > *choices ) {
 	
 	/* Create array of results for parallel reduction */
@@ -83,8 +166,8 @@ template< uint32_t dims > uint32_t inline PartitionBased< dims >
 	for( uint32_t i = 0; i < choices->size(); ++i ) {
 		auto choice = choices->begin() + i;
 		auto next = partitions->begin() + *choice;
-		if( next->points[ 0 ] < min_id[ omp_get_thread_num() ] ) {
-			min_id[ omp_get_thread_num() ] = next->points[ 0 ];
+		if( order_[ next->begin ] < min_id[ omp_get_thread_num() ] ) {
+			min_id[ omp_get_thread_num() ] = order_[ next->begin ];
 		}
 	}
 	
@@ -96,25 +179,27 @@ template< uint32_t dims > uint32_t inline PartitionBased< dims >
 }
 
 
-template< uint32_t dims > void inline PartitionBased< dims >
+template< uint32_t dims, typename V > void inline PartitionBased< dims, V >
 ::sort_by_volume() {
 	
-	/* First calculate the volume for every point in parallel. */
+	/* First calculate the volume for every point in parallel (unless InitBlock() did). */
+	if( !prescored_ ) {
 #pragma omp parallel for
-	for( uint32_t i = 0; i < n_; ++i ) {
-		float volume = 1;
-		for( uint32_t d = 0; d < dims; ++d ) {
-			volume *= ( 1 - data_[ i ].elems[ d ] );
+		for( uint32_t i = 0; i < n_; ++i ) {
+			float volume = 1;
+			for( uint32_t d = 0; d < dims; ++d ) {
+				volume *= ( 1 - FromSpace( ranks_, d, data_[ i ].elems[ d ] ) );
+			}
+			data_[ i ].score = volume;
 		}
-		data_[ i ].score = volume;
 	}
 	
-	/* Then use built-in parallel sort to sort points by volume */
-	std::__parallel::sort( data_, data_ + n_, std::greater< PTuple< dims > >() );
+	/* Then sort points by volume, moving only their keys until the end */
+	SortByKey( data_, n_, PartitionScoreGreater() );
 }
 
 
-template< uint32_t dims > void inline PartitionBased< dims >
+template< uint32_t dims, typename V > void inline PartitionBased< dims, V >
 ::copy_result( std::vector< answer > &q, const uint32_t k) {
 	
 	for( uint32_t i = 0; i < k; ++i ) {
@@ -130,9 +215,13 @@ template< uint32_t dims > void inline PartitionBased< dims >
 }
 
 
-template< uint32_t dims > std::vector< uint32_t > PartitionBased< dims >
-::Execute( const uint32_t k ) {
-	
+template< uint32_t dims, typename V > std::vector< uint32_t > PartitionBased< dims, V >
+::Execute( const uint32_t requested_k ) {
+
+	/* No more than all n_ points can be returned, and the pruning bounds 
+	 * assume that k of them exist. */
+	const uint32_t k = std::min( requested_k, n_ );
+
 	/* Create a partitioning and a double buffer copy */
 	Partitioning< dims > *occupied_partitions = new Partitioning< dims >(),
 		*occupied_partitions_db = new Partitioning< dims >();
@@ -148,16 +237,20 @@ template< uint32_t dims > std::vector< uint32_t > PartitionBased< dims >
 	std::make_heap( q.begin(), q.end(), maxAnswer );
 	
 	/* Push every point into original partition (entire data space) */
+	order_.resize( n_ );
+	order_db_.resize( n_ );
+	for( uint32_t i = 0; i < n_; ++i ) { order_[ i ] = i; }
 	occupied_partitions->push_back( Partition< dims >( n_ ) );
-	for( uint32_t i = 0; i < n_; ++i ) {
-		occupied_partitions->back().points.push_back( i );
-	}
 	active_partitions.push_back( 0 ); // make this partition is active
 	
 	
 	/* First, sort by volume of dominance area. */
 	sort_by_volume();
 	
+	/* The order is now final, so tile the points for the lattice mask pass. */
+	tiles_.Build( data_, n_ );
+	masks_.resize( tiles_.num_tiles() * TILE_WIDTH );
+	
 	/* print out sorted data for testing. 
 	for( uint32_t i = 0; i < n_; ++i ) {
 		std::cout << data_[ i ] << std::endl;
@@ -179,56 +272,84 @@ template< uint32_t dims > std::vector< uint32_t > PartitionBased< dims >
 		uint32_t pivot_score = 0;
 		active_partitions.clear();
 		
-		#pragma omp parallel for
-		for( uint32_t i = 1; i < n_; ++i ) {
-			data_[ i ].partition = DT_bitmap_dvc( data_[ i ], data_[ pivot ] );
+		/* Stream the lattice masks w.r.t. the pivot into the compact masks_ array. */
+		LatticeMasks( data_[ pivot ], tiles_, masks_.data() );
+		
+		/* Partition bounds are in the original space, so split them on the pivot's values */
+		Tuple< dims > pivot_values;
+		for( uint32_t d = 0; d < dims; ++d ) {
+			pivot_values.elems[ d ] = FromSpace( ranks_, d, data_[ pivot ].elems[ d ] );
 		}
 		
 		/* Sanity check -- which pivot did we choose? 
 		std::cout << pivot << data_[ pivot ] << std::endl;
 		*/
 		
-		/* Sub-partition our partitioning based on newly generated bitmasks */
+		/* Sub-partition our partitioning based on newly generated bitmasks. Each 
+		 * partition is split with a counting sort on the masks of its points, 
+		 * from its range of order_ into the same range of order_db_ (stable, 
+		 * so that the first point of a partition stays its best). First count 
+		 * the subpartitions of every partition, to know where in the new 
+		 * partitioning each partition's subpartitions go. */
 		swap( &occupied_partitions, &occupied_partitions_db );
-		Partitioning< dims > occ_parts_per_thread[ t_ ]; // array for parallel reduction
-		#pragma omp parallel for reduction( +: pivot_score )
-		for( uint32_t i = 0; i < occupied_partitions_db->size(); ++i ) {
+		const uint32_t num_split = occupied_partitions_db->size();
+		std::vector< uint32_t > first_sub( num_split + 1, 0 );
+		#pragma omp parallel
+		{
+		std::vector< uint32_t > counts( 1 << dims, 0 ), touched;
+		#pragma omp for schedule( dynamic, 16 )
+		for( uint32_t i = 0; i < num_split; ++i ) {
+			const Partition< dims > &toBeSplit = occupied_partitions_db->at( i );
+			count_masks( order_.data(), toBeSplit.begin, toBeSplit.end, pivot, 
+				masks_.data(), counts.data(), touched );
+			first_sub[ i + 1 ] = touched.size();
+			for( auto p = touched.begin(); p != touched.end(); ++p ) { counts[ *p ] = 0; }
+			touched.clear();
+		}
+		}
+		for( uint32_t i = 0; i < num_split; ++i ) { first_sub[ i + 1 ] += first_sub[ i ]; }
+		occupied_partitions->resize( first_sub[ num_split ] );
+		
+		/* Then split every partition, writing its subpartitions in place. */
+		#pragma omp parallel reduction( +: pivot_score )
+		{
+		std::vector< uint32_t > counts( 1 << dims, 0 ), touched;
+		#pragma omp for schedule( dynamic, 16 )
+		for( uint32_t i = 0; i < num_split; ++i ) {
 		
 			/* Grab the next partition to split */
-			Partition< dims > &toBeSplit = occupied_partitions_db->at( i );
-			const uint32_t prev_score = toBeSplit.upper_bound_score;
-			
-			/* Conduct the actual sub-partitioning */
-			std::unordered_map< uint32_t, Partition< dims > > subpartitions;
-			for( auto it = toBeSplit.points.begin(); it != toBeSplit.points.end(); ++it ) {
-				if( *it == pivot ) { continue; }
-				const uint32_t p = data_[ *it ].partition;
-				if( subpartitions.count( p ) == 0 ) {
-					
-					subpartitions[ p ] = Partition< dims >( 0 );
-					generate_coordinates( toBeSplit, subpartitions[ p ], p, data_[ pivot ] );
-				}
-				subpartitions[ p ].points.push_back( *it );
-			}
+			const Partition< dims > &toBeSplit = occupied_partitions_db->at( i );
+			count_masks( order_.data(), toBeSplit.begin, toBeSplit.end, pivot, 
+				masks_.data(), counts.data(), touched );
 			
-			/* Increment pivot's score if there is a relevant subpartition. */
-			if( subpartitions.count( dominated_mask ) > 0 ) {
-				pivot_score += subpartitions[ dominated_mask ].points.size();
+			/* Lay out the subpartitions one after another in the range (the 
+			 * pivot leaves a gap at the end), turning counts into cursors. */
+			uint32_t next = toBeSplit.begin;
+			for( uint32_t x = 0; x < touched.size(); ++x ) {
+				const uint32_t p = touched[ x ];
+				Partition< dims > &sub = occupied_partitions->at( first_sub[ i ] + x );
+				sub = Partition< dims >( 0 );
+				generate_coordinates( toBeSplit, sub, p, pivot_values );
+				sub.begin = next;
+				sub.end = next + counts[ p ];
+				counts[ p ] = next;
+				next = sub.end;
+				
+				/* Increment pivot's score if this is the relevant subpartition. */
+				if( p == dominated_mask ) { pivot_score += sub.size(); }
 			}
 			
-			/* Copy all the subpartitions into our parallel-reduction array */
-			for( auto it = subpartitions.begin(); it != subpartitions.end(); ++it ) {
-				occ_parts_per_thread[ omp_get_thread_num() ].push_back( it->second );
+			/* Conduct the actual sub-partitioning */
+			for( uint32_t j = toBeSplit.begin; j < toBeSplit.end; ++j ) {
+				if( order_[ j ] == pivot ) { continue; }
+				order_db_[ counts[ masks_[ order_[ j ] ] ]++ ] = order_[ j ];
 			}
+			for( auto p = touched.begin(); p != touched.end(); ++p ) { counts[ *p ] = 0; }
+			touched.clear();
 		}
-		occupied_partitions_db->clear(); // these have all been sub-partitioned now.
-		
-		/* Complete parallel reduction */
-		for( uint32_t i = 0; i < t_; ++i ) {
-			if( occ_parts_per_thread[ i ].size() == 0 ) { continue; }
-			occupied_partitions->insert( occupied_partitions->end(), 
-				occ_parts_per_thread[ i ].begin(), occ_parts_per_thread[ i ].end() );
 		}
+		order_.swap( order_db_ );
+		occupied_partitions_db->clear(); // these have all been sub-partitioned now.
 		
 		/* Check if this pivot qualifies for our current top k solution */
 		if( pivot_score > q.front().first ) {
@@ -251,7 +372,7 @@ template< uint32_t dims > std::vector< uint32_t > PartitionBased< dims >
 			// Add counts for any other partition that this one can (partially or not) dominate 
 			for( auto it = occupied_partitions->begin(); it != occupied_partitions->end(); ++it ) { 
 				if( DominateLeftDVC( occupied_partitions->at( i ).lower_bound_coord, it->lower_bound_coord ) ) { 
-					occupied_partitions->at( i ).upper_bound_score += it->points.size();
+					occupied_partitions->at( i ).upper_bound_score += it->size();
 				}
 			}
 			if( occupied_partitions->at( i ).upper_bound_score > q.front().first ) {
@@ -20,6 +20,9 @@
 #endif
 
 #include "common/common.h"
+#include "common/key_sort.h"
+#include "common/rank_space.h"
+#include "common/soa_tiles.h"
 #include "common/tkdq_solver.h"
 #include "partition_based/partition.h"
 
@@ -29,28 +32,38 @@
 
 typedef std::pair< uint32_t, uint32_t > answer; /**< A (# points dominated, point id) pair */
 template< uint32_t dims >
-using Partitioning = std::vector< Partition< dims > >; /**< A set of non-empty partitions */
+using Partitioning = std::vector< Partition< dims > >; /**< A set of non-empty partitions, each a range of one permutation */
 
 /**
  * A class for executing our Naive algorithm to compute top-k dominating queries.
  * 
  * @tparam DIMS The number of dimensions in the input dataset.
+ * @tparam V The type of the tuple values: float, or rank_t to run on 
+ * the dataset transformed into rank space (see RankSpace).
+ * Partition bounds are always kept in the original (float) space.
  */
-template< uint32_t dims >
+template< uint32_t dims, typename V = float >
 class PartitionBased: public TKDQ_Solver {
 
 public:
 	
-	PartitionBased(uint32_t threads, uint32_t n, float** data ) :
-      t_(threads), n_(n) {
+	PartitionBased(uint32_t threads, uint32_t n, const Dataset &data, 
+      const RankSpace *ranks = NULL ) :
+      t_(threads), n_(n), ranks_(ranks) {
 
     omp_set_num_threads( threads );
     result_.reserve(1024);
     data_ = NULL;
+    owns_data_ = false;
+    prescored_ = false;
   }
 
-	~PartitionBased() { }
-  void Init( float** data );
+	~PartitionBased() { if( owns_data_ ) { delete[] data_; } }
+  void Init( const Dataset &data );
+  void InitInPlace( Dataset &data );
+  void BeginInit( const Dataset &data );
+  void InitBlock( const Dataset &data, const uint32_t begin, const uint32_t end );
+  void FinishInit( const Dataset &data );
 	std::vector< uint32_t > Execute( const uint32_t k );
 
 
@@ -59,8 +72,15 @@ protected:
   // Data members:
   uint32_t n_; /**< The number of points in the dataset. */
   const uint32_t t_; /**< The number of threads with which the solution should be obtained. */
-  PTuple< dims >* data_; /**< The internal representation of the dataset. */
+  PTuple< dims, V >* data_; /**< The internal representation of the dataset. */
+  const RankSpace *ranks_; /**< The rank space of the dataset, if V is rank_t */
+  bool owns_data_; /**< True if data_ was allocated (rather than adopted) */
+  bool prescored_; /**< True if InitBlock() computes the volumes */
   std::vector< uint32_t > result_; /**< The vector that will contain the result point ids */
+  SoATiles< dims, V > tiles_; /**< Tiled copy of data_ in volume order, for LatticeMasks() */
+  std::vector< uint32_t > masks_; /**< The lattice mask of each point w.r.t. the current pivot */
+  std::vector< uint32_t > order_; /**< The points, grouped by partition (see Partition::begin) */
+  std::vector< uint32_t > order_db_; /**< Double buffer of order_, into which partitions are split */
 
 private:
 	
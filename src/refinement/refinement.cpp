@@ -20,83 +20,213 @@ template class Refinement< 7 >;
 template class Refinement< 8 >;
 template class Refinement< 9 >;
 template class Refinement< 10 >;
+template class Refinement< 2, rank_t >;
+template class Refinement< 3, rank_t >;
+template class Refinement< 4, rank_t >;
+template class Refinement< 5, rank_t >;
+template class Refinement< 6, rank_t >;
+template class Refinement< 7, rank_t >;
+template class Refinement< 8, rank_t >;
+template class Refinement< 9, rank_t >;
+template class Refinement< 10, rank_t >;
 
 
-template< uint32_t dims >
-void Refinement< dims >
-::Init( float** data ) {
+template< uint32_t dims, typename V >
+void Refinement< dims, V >
+::Init( const Dataset &data ) {
 
 	/* Allocate space. */
-	data_ = new PTuple< dims >[n_];
+	data_ = new PTuple< dims, V >[n_];
+	owns_data_ = true;
 	
-	/* Copy data from float array into tuple array and record
-	 * point ids. */
+	/* Copy (or rank-transform) data from the dataset into tuple array 
+	 * and record point ids. */
 #pragma omp parallel for
 	for ( uint32_t i = 0; i < n_; ++i ) {
 		data_[ i ].pid = i;
 		data_[ i ].score = 0;
-		memcpy( data_[ i ].elems, data[ i ], sizeof( float ) * dims );
+		const float *row = data.row( i );
+		for( uint32_t d = 0; d < dims; ++d ) {
+			data_[ i ].elems[ d ] = ToSpace< V >( ranks_, d, row[ d ] );
+		}
 	}
 }
 
-template< uint32_t dims > uint32_t Refinement< dims > 
-::counting_pass( const uint32_t k ) {
+template< uint32_t dims, typename V >
+void Refinement< dims, V >
+::InitInPlace( Dataset &data ) {
 
-	/* Init data structures with all zeroes */
-	std::array< uint32_t, ( 1 << dims ) > cell_counts;
-	for( uint32_t i = 0; i < ( 1 << dims ); ++i ) {
-		cell_counts[ i ] = 0;
-		cell_dom_by_counts_[ i ] = 0;
+	/* Fall back to copying if the rows are not laid out as tuples. */
+	data_ = AdoptTuples< dims, V >( data );
+	if( data_ == NULL ) { Init( data ); return; }
+	owns_data_ = false;
+	
+	/* Only the point ids and scores need to be written. */
+#pragma omp parallel for
+	for ( uint32_t i = 0; i < n_; ++i ) {
+		data_[ i ].pid = i;
+		data_[ i ].score = 0;
+	}
+}
+
+template< uint32_t dims, typename V >
+void Refinement< dims, V >
+::BeginInit( const Dataset &data ) {
+	data_ = new PTuple< dims, V >[n_];
+	owns_data_ = true;
+}
+
+
+template< uint32_t dims, typename V >
+void Refinement< dims, V >
+::InitBlock( const Dataset &data, const uint32_t begin, 
+	const uint32_t end ) {
+
+	/* Copy the block (the grid needs all of the data, so cells are only 
+	 * assigned by the counting pass). */
+	for ( uint32_t i = begin; i < end; ++i ) {
+		data_[ i ].pid = i;
+		data_[ i ].score = 0;
+		data_[ i ].partition = 0;
+		const float *row = data.row( i );
+		for( uint32_t d = 0; d < dims; ++d ) {
+			data_[ i ].elems[ d ] = ToSpace< V >( ranks_, d, row[ d ] );
+		}
 	}
+}
+
+
+template< uint32_t dims, typename V >
+void Refinement< dims, V >
+::FinishInit( const Dataset &data ) {
+	if( data_ == NULL ) { Init( data ); }
+}
+
+
+template< uint32_t dims, typename V > void Refinement< dims, V > 
+::build_grid() {
 	
-	/* Statically build a midpoint to partition a static grid with */
-	Tuple< dims > midpoint;
-	for( uint32_t i = 0; i < dims; ++i ) { midpoint.elems[ i ] = 0.5; }
+	/* Split each dimension (in parallel) into intervals_ intervals of equal 
+	 * population. On skewed data, some split points may coincide, leaving 
+	 * empty intervals between them. Each split point is selected from the 
+	 * values not below the previous one, so the column is never sorted. */
+	const uint32_t num_splits = intervals_ - 1;
+	splits_.resize( dims * num_splits );
+	#pragma omp parallel for schedule( dynamic, 1 )
+	for( uint32_t d = 0; d < dims; ++d ) {
+		std::vector< V > column( n_ );
+		for( uint32_t i = 0; i < n_; ++i ) { column[ i ] = data_[ i ].elems[ d ]; }
+		typename std::vector< V >::iterator from = column.begin();
+		for( uint32_t s = 0; s < num_splits; ++s ) {
+			const typename std::vector< V >::iterator nth = 
+				column.begin() + (uint64_t) ( s + 1 ) * n_ / intervals_;
+			if( nth >= from ) {
+				std::nth_element( from, nth, column.end() );
+				from = nth + 1;
+			}
+			splits_[ d * num_splits + s ] = *nth;
+		}
+	}
+	
+	/* Decode the interval of every cell in every dimension. */
+	cell_coords_.resize( num_cells_ * dims );
+	for( uint32_t c = 0; c < num_cells_; ++c ) {
+		for( uint32_t d = 0, rest = c; d < dims; ++d, rest /= intervals_ ) {
+			cell_coords_[ c * dims + d ] = rest % intervals_;
+		}
+	}
 	
-	/* Assign each point to a grid relative to the midpoint */
+	/* Assign each point to its cell: in each dimension, the interval above 
+	 * the last split point that is <= its value. */
 	#pragma omp parallel for
 	for( uint32_t i = 0; i < n_; ++i ) {
-		data_[ i ].partition = DT_bitmap_dvc( data_[ i ], midpoint );
+		uint32_t cell = 0;
+		for( uint32_t d = dims; d-- > 0; ) {
+			const V *splits = &splits_[ d * num_splits ];
+			const uint32_t interval = 
+				std::upper_bound( splits, splits + num_splits, data_[ i ].elems[ d ] ) - splits;
+			cell = cell * intervals_ + interval;
+		}
+		data_[ i ].partition = cell;
 	}
+}
+
+template< uint32_t dims, typename V > void Refinement< dims, V > 
+::sum_over_cells( std::vector< uint32_t > &sums, const bool above ) const {
+	
+	/* Prefix (or suffix) sums along one dimension at a time: after dimension 
+	 * d, sums[ c ] covers the cells that agree with c beyond d and lie weakly 
+	 * below (or above) it up to d. The lines along d are summed in parallel. */
+	const uint32_t num_lines = num_cells_ / intervals_;
+	for( uint32_t d = 0, stride = 1; d < dims; ++d, stride *= intervals_ ) {
+		#pragma omp parallel for
+		for( uint32_t line = 0; line < num_lines; ++line ) {
+			uint32_t *first = &sums[ ( line / stride ) * stride * intervals_ + line % stride ];
+			if( above ) {
+				for( int32_t j = intervals_ - 2; j >= 0; --j ) { first[ j * stride ] += first[ ( j + 1 ) * stride ]; }
+			}
+			else {
+				for( uint32_t j = 1; j < intervals_; ++j ) { first[ j * stride ] += first[ ( j - 1 ) * stride ]; }
+			}
+		}
+	}
+}
+
+template< uint32_t dims, typename V > uint32_t Refinement< dims, V > 
+::counting_pass( const uint32_t k ) {
+
+	/* Init data structures with all zeroes */
+	std::vector< uint32_t > cell_counts( num_cells_, 0 );
+	cell_dom_by_counts_.assign( num_cells_, 0 );
+	directory_.resize( num_cells_ );
+	grid_cell_bounds_.assign( num_cells_, Bounds( 0, 0 ) );
+	pruned_.assign( num_cells_, 0 );
+	candidates_.assign( num_cells_, CandidateSet() );
+	
+	/* Build a grid at the quantiles of the data and assign each point to a cell */
+	build_grid();
 	
 	/* Sort the data so that all points in the same grid are adjacent */
-	std::__parallel::sort( data_, data_ + n_, std::less< PTuple< dims > >() );
+	SortByKey( data_, n_, PartitionScoreLess() );
 	
-	/* Populate population counts for each cell */
-	uint32_t start = 0;
-	for( uint32_t i = 0; i < n_; ++i ) {
-		if( data_[ i ].partition != data_[ start ].partition ) {
-			cell_counts[ data_[ start ].partition ] = i - start;
-			start = i;
-		}
+	/* Record where each cell's points begin and end, and thus its count */
+	for( uint32_t c = 0; c < num_cells_; ++c ) {
+		const CellRun empty = { c, 0, 0 };
+		directory_[ c ] = empty;
+	}
+	for( uint32_t begin = 0, end = 0; begin < n_; begin = end ) {
+		const uint32_t cell = data_[ begin ].partition;
+		while( end < n_ && data_[ end ].partition == cell ) { ++end; }
+		directory_[ cell ].begin = begin;
+		directory_[ cell ].end = end;
+		cell_counts[ cell ] = end - begin;
 	}
-	cell_counts[ data_[ start ].partition ] = n_ - start - 1; //last occupied cell
-	const uint32_t last_mask = data_[ start ].partition; // bound on max cell id
 	
 	/* Sanity check: print out partition counts 
-	for( uint32_t i = 0; i <= last_mask; ++i ) { 
+	for( uint32_t i = 0; i < num_cells_; ++i ) { 
 		std::cout << i << " " << cell_counts[ i ] << std::endl;
 	}
 	*/
 	
-	/* Calculate bounds for each cell, meanwhile maintaining order of lower bounds */
-	std::vector< std::pair< uint32_t, uint32_t > > pq;
-	//#pragma omp parallel for <-- disabled because 
-	// priority queue + cell_dom_by_counts not parallel friendly (NPF)!
-	for( uint32_t i = 0; i <= last_mask; ++i ) {
-		uint32_t upper_bound = 0, lower_bound = 0;
-		for( uint32_t j = i; j <= last_mask; ++j ) { 
-			if( ( i & j ) == i ) {
-				upper_bound += cell_counts[ j ];
-				if( i == 0 && j == ( ( 1 << dims ) - 1 ) ) { // fully dominates
-					lower_bound += cell_counts[ j ];
-					cell_dom_by_counts_[ j ] += cell_counts[ i ]; //NPF!!!
-				}
-			}
+	/* Calculate bounds for each cell from the counts of all the cells weakly 
+	 * above it and weakly below it. The cells strictly above cell i are those 
+	 * weakly above the cell one interval higher in every dimension (if i is 
+	 * not in the top interval of any dimension), and likewise for below. */
+	std::vector< uint32_t > above( cell_counts ), below( cell_counts );
+	sum_over_cells( above, true );
+	sum_over_cells( below, false );
+	uint32_t diagonal = 0; // the offset of the cell one interval higher in every dimension
+	for( uint32_t d = 0, stride = 1; d < dims; ++d, stride *= intervals_ ) { diagonal += stride; }
+	#pragma omp parallel for
+	for( uint32_t i = 0; i < num_cells_; ++i ) {
+		bool top = false, bottom = false;
+		for( uint32_t d = 0; d < dims; ++d ) {
+			top |= ( cell_coords_[ i * dims + d ] == intervals_ - 1 );
+			bottom |= ( cell_coords_[ i * dims + d ] == 0 );
 		}
-		grid_cell_bounds_[ i ].first = lower_bound;
-		grid_cell_bounds_[ i ].second = upper_bound;
-		pq.push_back( std::pair< uint32_t, uint32_t > ( lower_bound, cell_counts[ i ] ) );//NPF!!!
+		grid_cell_bounds_[ i ].first = top ? 0 : above[ i + diagonal ]; // fully dominates
+		grid_cell_bounds_[ i ].second = above[ i ];
+		cell_dom_by_counts_[ i ] = bottom ? 0 : below[ i - diagonal ]; // fully dominated
 	}
 	
 	/* Sanity check: print out the bounds that we derived. 
@@ -105,24 +235,25 @@ template< uint32_t dims > uint32_t Refinement< dims >
 	}
 	*/
 	
-	/* compute minimum lower bound score that may contain TKDQ points. */
-	std::make_heap( pq.begin(), pq.end(), std::less< std::pair< uint32_t, uint32_t > >() );
-	uint32_t gamma = 0, points_seen = 0;
-	while( !pq.empty() && points_seen < k ) {
-		
-		/* Update gamma threshold with next from the heap. */
-		std::pair< uint32_t, uint32_t > &next = pq.front();
-		gamma += next.first;
-		points_seen += next.second;
-		
-		/* Pop it off the queue. */
-		std::pop_heap( pq.begin(), pq.end(), std::less< std::pair< uint32_t, uint32_t > >() ); 
-		pq.pop_back();
+	/* compute minimum lower bound score that may contain TKDQ points: the 
+	 * k'th highest lower bound of any point, i.e., the highest gamma such 
+	 * that the cells with lower bound >= gamma hold at least k points. It 
+	 * is found by bisection, counting those points in parallel each step. */
+	uint32_t gamma = 0, too_high = n_ + 1;
+	while( gamma + 1 < too_high ) {
+		const uint32_t mid = gamma + ( too_high - gamma ) / 2;
+		uint32_t points_seen = 0;
+		#pragma omp parallel for reduction( + : points_seen )
+		for( uint32_t i = 0; i < num_cells_; ++i ) {
+			if( grid_cell_bounds_[ i ].first >= mid ) { points_seen += cell_counts[ i ]; }
+		}
+		if( points_seen >= k ) { gamma = mid; }
+		else { too_high = mid; }
 	}
 	
 	/* Determine which partitions can be explicitly pruned froms scores and on gamma. */
 	#pragma omp parallel for
-	for( uint32_t i = 0; i < ( 1 << dims ); ++i ) {
+	for( uint32_t i = 0; i < num_cells_; ++i ) {
 		if( cell_counts[ i ] == 0 ) { pruned_[ i ] = true; }
 		else if( grid_cell_bounds_[ i ].second < gamma ) { pruned_[ i ] = true; }
 		else if( cell_dom_by_counts_[ i ] >= k ) { pruned_[ i ] = true; }
@@ -133,17 +264,11 @@ template< uint32_t dims > uint32_t Refinement< dims >
 }
 
 
-template< uint32_t dims > void Refinement< dims >
+template< uint32_t dims, typename V > void Refinement< dims, V >
 ::prepare_result( const uint32_t k ) {
 	
-	/* Sort all the data points by the dominance score (pruned ones have score = 0 ) */
-	std::__parallel::sort( data_, data_ + n_, std::greater< STuple< dims > >() );
-	
-	/* Then copy k first points into result vector */
-	for( uint32_t i = 0; i < k; ++i ) {
-		result_.push_back( data_[ i ].pid );
-		//std::cout << i << " " << data_[ i ] << std::endl;
-	}
+	/* Select the k points with the best dominance scores (pruned ones have score = 0 ) */
+	result_ = TopKByScore( data_, n_, k );
 }
 
 
@@ -155,105 +280,242 @@ template< uint32_t dims > void Refinement< dims >
 // in Algorithm 7.
 // Also, haven't implemented Line 6 since this seems to be related to 
 // the irrelevance bit.
-template< uint32_t dims > void Refinement< dims >
-::refinement_pass( ) {
+template< uint32_t dims, typename V > template< typename Block > void Refinement< dims, V >
+::refinement_pass( const Block &points, const uint32_t k ) {
+	
+	/* Create flattened list of candidates for better parallel workload balance, 
+	 * best-first: in decreasing order of the upper bounds of their cells. */
+	std::vector< uint32_t > cells, flat_candidates;
+	for( uint32_t c = 0; c < num_cells_; ++c ) {
+		if( !candidates_[ c ].empty() ) { cells.push_back( c ); }
+	}
+	const std::vector< Bounds > &bounds = grid_cell_bounds_;
+	std::stable_sort( cells.begin(), cells.end(), [ &bounds ]( const uint32_t a, const uint32_t b ) {
+		return bounds[ a ].second > bounds[ b ].second;
+	} );
+	for( auto it = cells.begin(); it != cells.end(); ++it ) {
+		flat_candidates.insert( flat_candidates.end(), candidates_[ *it ].begin(), candidates_[ *it ].end() );
+	}
 	
-	/* Create flattened list of candidates for better parallel workload balance */
-	std::vector< uint32_t > flat_candidates;
-	for( auto it = candidates_.begin(); it != candidates_.end(); ++it ) {
-		flat_candidates.insert( flat_candidates.end(), it->begin(), it->end() );
+	/* A candidate dominates every point of the cells strictly above its own, 
+	 * which its lower bound already counts, and no point of a cell not 
+	 * weakly above its own. So, for each cell with candidates, only the 
+	 * other cells weakly above it are looked up in the directory, and their 
+	 * ranges (merged where they abut) are all that its candidates scan. 
+	 * (Points of pruned cells cannot be results, but they still count 
+	 * towards the scores of the candidates that dominate them.) */
+	std::vector< std::vector< CellRun > > ranges( num_cells_ );
+	std::vector< uint32_t > range_sizes( num_cells_, 0 ); // the points in a cell's ranges
+	#pragma omp parallel for schedule( dynamic )
+	for( uint32_t x = 0; x < cells.size(); ++x ) {
+		const uint32_t c = cells[ x ];
+		ranges[ c ] = partially_above( c ); // Line 11
+		for( auto run = ranges[ c ].begin(); run != ranges[ c ].end(); ++run ) {
+			range_sizes[ c ] += run->end - run->begin;
+		}
 	}
 	
+	/* A lower bound on the k'th best score: the highest k'th best score 
+	 * that any thread has found so far. A candidate whose upper bound falls 
+	 * below it cannot make the top-k (not even on a tie); since the 
+	 * candidates come best-first, once one does, so do nearly all after it. */
+	uint32_t threshold = 0;
+	
 	/* Iterate every candidate point, computing its score */
-	#pragma omp parallel for schedule ( dynamic, 16 )
+	#pragma omp parallel
+	{
+	std::priority_queue< uint32_t, std::vector< uint32_t >, std::greater< uint32_t > > best;
+	#pragma omp for schedule ( dynamic, 16 )
 	for( uint32_t i = 0; i < flat_candidates.size(); ++i ) { // Line 12 (sort of)
 		const uint32_t index = flat_candidates[ i ];
 		const uint32_t my_partition = data_[ index ].partition;
+		if( grid_cell_bounds_[ my_partition ].second < __atomic_load_n( &threshold, __ATOMIC_RELAXED ) ) {
+			continue; // Line 3
+		}
+		const std::vector< CellRun > &my_ranges = ranges[ my_partition ];
 		
-		/* Iterate dataset to calculate the score of this candidate */
-		// To be more fair, we should iterate partitions a la my ICDE/PVLDB papers
-		// I.e., build a map from partition to start index so we can skip entire 
-		// partitions at once. But I don't think this is a hot spot of the code.
-		for( uint32_t other = 0; other < n_; ++other ) {
-			const uint32_t your_partition = data_ [ other ].partition;
-		
-			/* Skip the point if there is a reason to */
-			if( pruned_[ your_partition ] ) { continue; } // Line 3,9 (sort of)
-			if( ( my_partition & your_partition ) == my_partition ) { // Line 11
-				if( DominateLeft< dims >( data_[ index ], data_[ other ] ) ) { // Line 12 (sort of)
-					++data_[ index ].score; // Line 13 (sort of)
-				}
+		/* Count the dominated points, abandoning the candidate as soon as the 
+		 * rest of its ranges cannot lift it to the threshold. */
+		uint32_t score = grid_cell_bounds_[ my_partition ].first;
+		uint32_t remaining = range_sizes[ my_partition ];
+		bool abandoned = false;
+		for( auto run = my_ranges.begin(); run != my_ranges.end() && !abandoned; ++run ) {
+			abandoned = ( score + remaining < __atomic_load_n( &threshold, __ATOMIC_RELAXED ) );
+			if( !abandoned ) {
+				score += count_dominated( data_[ index ], points, run->begin, run->end ); // Line 12, 13 (sort of)
+				remaining -= run->end - run->begin;
 			}
 		}
+		if( abandoned ) { continue; }
+		
+		/* Publish the score, and the thread's k'th best so far as the threshold. */
+		data_[ index ].score = score;
+		best.push( score );
+		if( best.size() > k ) { best.pop(); }
+		if( k > 0 && best.size() == k ) { raise_threshold( &threshold, best.top() ); }
+	}
 	}
 }
 
 
-template< uint32_t dims > void Refinement< dims >
-::coarse_grained_filter( const uint32_t gamma, const uint32_t k ) {
+template< uint32_t dims, typename V > std::vector< CellRun > Refinement< dims, V >
+::partially_above( const uint32_t cell ) const {
 	
-	/* Create an array of counts for how many times each point has been dominated */
-	std::vector< uint32_t > dom_counts;
-	dom_counts.reserve( n_ );
+	/* Enumerate the box of cells weakly above cell, in increasing order of 
+	 * cell id, like an odometer with dimension 0 turning fastest. */
+	std::vector< CellRun > ranges;
+	const uint8_t *low = &cell_coords_[ cell * dims ];
+	uint32_t coords[ dims ], strides[ dims ];
+	for( uint32_t d = 0, stride = 1; d < dims; ++d, stride *= intervals_ ) {
+		coords[ d ] = low[ d ];
+		strides[ d ] = stride;
+	}
+	for( uint32_t c = cell; ; ) {
+		
+		/* Add the cell's points, unless they are all dominated. */
+		bool strictly = true;
+		for( uint32_t d = 0; d < dims; ++d ) { strictly &= ( coords[ d ] > low[ d ] ); }
+		const CellRun &run = directory_[ c ];
+		if( !strictly && run.end > run.begin ) {
+			if( !ranges.empty() && ranges.back().end == run.begin ) { ranges.back().end = run.end; }
+			else { ranges.push_back( run ); }
+		}
+		
+		/* Step to the next cell of the box. */
+		uint32_t d = 0;
+		for( ; d < dims && coords[ d ] == intervals_ - 1; ++d ) {
+			c -= ( coords[ d ] - low[ d ] ) * strides[ d ];
+			coords[ d ] = low[ d ];
+		}
+		if( d == dims ) { break; }
+		++coords[ d ];
+		c += strides[ d ];
+	}
+	return ranges;
+}
+
+
+template< uint32_t dims, typename V > void Refinement< dims, V >
+::coarse_grained_filter( const uint32_t gamma, const uint32_t k ) {
 	
-	/* Iterate all points to determine if they should be candidates */
-	//#pragma omp parallel for //<--note! means points against which p are compared is non-deterministic!
-	for( uint32_t i = 0; i < n_; ++i ) { // Line 4
-		const uint32_t p = data_[ i ].partition; // Line 5
-		const uint32_t lower_bound = grid_cell_bounds_[ p ].first; // Line 6
-		const uint32_t upper_bound = grid_cell_bounds_[ p ].second; // Line 6
-		dom_counts[ i ] = cell_dom_by_counts_[ p ]; // Line 6
-		bool done_processing = false;
-		for( uint32_t other_p = 0; other_p < p && !done_processing; ++other_p ) { // Line 12
-			if( ( p & other_p ) == other_p ) { // Line 12
-				for( auto it = candidates_[ other_p ].begin(); 
-					it != candidates_[ other_p ].end(); ++it ) { // Line 8
-					
-					if( DominateLeft< dims >( data_[ *it ], data_[ i ] ) ) { // Line 8
-						if( ++dom_counts[ i ] >= k ) { // Line 9, 10
-							done_processing = true; break; //Line 11
-						}
-					}
+	/* A point is only compared against candidates of its own cell and of the 
+	 * cells weakly below it, which all lie on lower levels of the lattice 
+	 * (the level of a cell being the sum of its intervals). So the cells are 
+	 * filtered in waves, one level at a time, each wave in parallel and only 
+	 * reading the finished candidates of earlier waves. Within a cell, the 
+	 * points are visited in order (as by Algorithm 5), so the result does 
+	 * not depend on the number of threads. */
+	std::vector< std::vector< uint32_t > > waves( dims * ( intervals_ - 1 ) + 1 );
+	for( uint32_t p = 0; p < num_cells_; ++p ) {
+		if( directory_[ p ].end > directory_[ p ].begin ) {
+			uint32_t level = 0;
+			for( uint32_t d = 0; d < dims; ++d ) { level += cell_coords_[ p * dims + d ]; }
+			waves[ level ].push_back( p );
+		}
+	}
+	std::vector< uint32_t > dom_counts( n_, 0 ); // how many times each point is dominated
+	std::vector< uint8_t > done( n_, 0 ), removed( n_, 0 ); // removed: tombstones
+	std::vector< uint32_t > filled; // the cells that have candidates, in earlier waves
+	std::vector< std::vector< uint32_t > > below( num_cells_ );
+	for( uint32_t level = 0; level < waves.size(); ++level ) {
+		
+		const std::vector< uint32_t > &cells = waves[ level ];
+		std::vector< uint32_t > points;
+		for( uint32_t x = 0; x < cells.size(); ++x ) {
+			for( uint32_t i = directory_[ cells[ x ] ].begin; i < directory_[ cells[ x ] ].end; ++i ) { points.push_back( i ); }
+		}
+		
+		/* List, for each cell, the earlier cells with candidates that may 
+		 * dominate its points. The candidates of cells strictly below it 
+		 * certainly do, and are already counted by cell_dom_by_counts_. */
+		#pragma omp parallel for schedule( dynamic )
+		for( uint32_t x = 0; x < cells.size(); ++x ) {
+			const uint32_t p = cells[ x ];
+			for( uint32_t y = 0; y < filled.size(); ++y ) {
+				const uint32_t other_p = filled[ y ];
+				if( weakly_below( other_p, p ) && !strictly_below( other_p, p ) ) { // Line 12
+					below[ p ].push_back( other_p );
 				}
 			}
 		}
-		// Could skip Lines 12-16 because not very parallel or cache friendly.
-		// But this means that points will not be visited later so less pruning.
-		for( uint32_t other_p = p; other_p < ( 1 << dims ) && !done_processing; ++other_p ) { // Line 7
-			if( ( p & other_p ) == p ) { // Line 7
-				auto it = candidates_[ other_p ].begin(); 
-				while( it != candidates_[ other_p ].end() ) { // Line 13
-					
-					if( DominateLeft< dims >( data_[ i ], data_[ *it ] ) ) { // Line 13
-						if( ++dom_counts[ *it ] >= k ) { // Line 14, 15
-							it = candidates_[ other_p ].erase( it ); //Line 16
-						}
-						else { ++it; }
-					}else { ++it; }
-				}
+		
+		/* First, count each point's dominators among the candidates of those cells. */
+		#pragma omp parallel for schedule( dynamic, 64 )
+		for( uint32_t x = 0; x < points.size(); ++x ) { // Line 4
+			const uint32_t i = points[ x ];
+			const uint32_t p = data_[ i ].partition; // Line 5
+			dom_counts[ i ] = cell_dom_by_counts_[ p ]; // Line 6
+			done[ i ] = ( dom_counts[ i ] >= k );
+			for( auto other_p = below[ p ].begin(); other_p != below[ p ].end() && !done[ i ]; ++other_p ) {
+				
+				/* Count dominating candidates until dom_counts reaches k. */
+				const uint32_t limit = k - dom_counts[ i ];
+				const uint32_t count = count_dominators_at( data_[ i ], data_, 
+					candidates_[ *other_p ].data(), candidates_[ *other_p ].size(), limit ); // Line 8
+				dom_counts[ i ] += count; // Line 9
+				done[ i ] = ( count >= limit ); // Line 10, 11
 			}
 		}
-		if( !done_processing && upper_bound >= gamma ) { // Line 17
-			candidates_[ p ].push_back( i ); // Line 18
+		
+		/* Then, every point that is not done bumps the counts of the earlier 
+		 * candidates of its cell that it dominates (Lines 7, 13-16; the 
+		 * superset cells have no candidates yet). Seen from the candidate, 
+		 * that is a count of the dominators among the later points of its 
+		 * cell that are not done, and it is removed as soon as one of those
+		 * brings its count to k. The points that are not done are first 
+		 * gathered, cell by cell, with the end of each one's cell. */
+		std::vector< uint32_t > live, live_end;
+		for( uint32_t x = 0; x < points.size(); ++x ) {
+			if( !done[ points[ x ] ] ) { live.push_back( points[ x ] ); }
+			if( x + 1 == points.size() || data_[ points[ x + 1 ] ].partition != data_[ points[ x ] ].partition ) {
+				live_end.resize( live.size(), live.size() );
+			}
+		}
+		#pragma omp parallel for schedule( dynamic, 64 )
+		for( uint32_t x = 0; x < live.size(); ++x ) {
+			const uint32_t c = live[ x ], end = live_end[ x ];
+			if( pruned_[ data_[ c ].partition ] ) { continue; } // Line 17
+			const uint32_t limit = k - dom_counts[ c ];
+			const uint32_t count = count_dominators_at( data_[ c ], data_, 
+				live.data() + x + 1, end - x - 1, limit ); // Line 13
+			dom_counts[ c ] += count; // Line 14
+			removed[ c ] = ( count >= limit ); // Line 15, 16
+		}
+		
+		/* Finally, collect each cell's surviving candidates, in order. */
+		#pragma omp parallel for schedule( dynamic )
+		for( uint32_t x = 0; x < cells.size(); ++x ) {
+			const uint32_t p = cells[ x ];
+			if( pruned_[ p ] ) { continue; } // Line 17
+			for( uint32_t i = directory_[ p ].begin; i < directory_[ p ].end; ++i ) {
+				if( !done[ i ] && !removed[ i ] ) { candidates_[ p ].push_back( i ); } // Line 18
+			}
+		}
+		for( uint32_t x = 0; x < cells.size(); ++x ) {
+			if( !candidates_[ cells[ x ] ].empty() ) { filled.push_back( cells[ x ] ); }
 		}
 	}
 }
 
 
-template< uint32_t dims > uint32_t Refinement< dims >
+template< uint32_t dims, typename V > uint32_t Refinement< dims, V >
 ::num_candidates() {
 	uint32_t count = 0;
-	for( uint32_t i = 0; i < ( 1 << dims ); ++i ) {
+	for( uint32_t i = 0; i < num_cells_; ++i ) {
 		count += candidates_[ i ].size();
 	}
 	return count;
 }
 
 
-template< uint32_t dims >
-std::vector< uint32_t > Refinement< dims >
-::Execute( const uint32_t k ) {
-	
+template< uint32_t dims, typename V >
+std::vector< uint32_t > Refinement< dims, V >
+::Execute( const uint32_t requested_k ) {
+
+	/* No more than all n_ points can be returned, and the pruning bounds 
+	 * assume that k of them exist. */
+	const uint32_t k = std::min( requested_k, n_ );
+
 	/* First, conduct counting pass. */
 	uint32_t gamma = counting_pass( k );
 	
@@ -263,7 +525,11 @@ std::vector< uint32_t > Refinement< dims >
 
 
 	/* Finally, conduct the refinement pass (Algorithm 7). */
-	refinement_pass();
+	if( soa_ ) {
+		tiles_.Build( data_, n_ );
+		refinement_pass( tiles_, k );
+	}
+	else { refinement_pass( data_, k ); }
 	
 	
 	/* Copy the top-k points into the output array and return it. */
@@ -13,6 +13,9 @@
 #include <cstdio>
 #include <map>
 #include <array>
+#include <vector>
+#include <queue>
+#include <functional>
 #include <sys/time.h>
 
 #if defined(_OPENMP)
@@ -25,46 +28,108 @@
 #endif
 
 #include "common/common.h" 
+#include "common/key_sort.h"
+#include "common/dominance_count.h"
+#include "common/rank_space.h"
+#include "common/soa_tiles.h"
 #include "common/tkdq_solver.h"
 
 
 
+const uint32_t REFINEMENT_MAX_INTERVALS = 64; /**< The most intervals into which the grid splits a dimension */
+const uint32_t REFINEMENT_MAX_CELLS = 1024; /**< The most cells in the grid */
+
 typedef std::pair< uint32_t, uint32_t > Bounds; /**< A [lower, upper] bound pair */
 typedef std::vector< uint32_t > CandidateSet; /**< List of indexes of candidate points */
 
+/**
+ * A run [begin, end) of points, in cell order, that lie in one cell (or, 
+ * once merged with the runs that abut it, starting in one cell).
+ */
+struct CellRun {
+	uint32_t cell; /**< The grid cell of the points */
+	uint32_t begin; /**< The first point of the run */
+	uint32_t end; /**< One past the last point of the run */
+};
+
 /**
  * A class for executing a Refinement algorithm to compute top-k 
  * dominating queries.
  * 
+ * The grid of the counting pass splits each dimension into the same 
+ * number of intervals at quantiles of the data (so that skewed data 
+ * still spreads over the cells), and a cell is identified by its 
+ * interval in every dimension, in mixed radix with dimension 0 least 
+ * significant. With two intervals, this is the bitmask of the dimensions 
+ * in which the cell lies above the median.
+ * 
  * @tparam DIMS The number of dimensions in the input dataset.
+ * @tparam V The type of the tuple values: float, or rank_t to run on 
+ * the dataset transformed into rank space (see RankSpace).
  */
-template< uint32_t dims >
+template< uint32_t dims, typename V = float >
 class Refinement: public TKDQ_Solver {
 
 public:
 	
 	/**
 	 * Constructs a new instance of a Refinement TKDQ solver
+	 * @param ranks The rank space of the dataset; required iff V is rank_t.
+	 * @param soa True if the refinement pass should test each candidate 
+	 * against a tile of points at a time, on a structure-of-arrays copy.
+	 * @param intervals The number of intervals into which the grid splits 
+	 * each dimension, or 0 to take as many as REFINEMENT_MAX_CELLS allows; 
+	 * it is clipped to [2, REFINEMENT_MAX_INTERVALS] and to that budget.
 	 * @post Creates a new Naive TKDQ solver instance.
 	 */
-  Refinement(uint32_t threads, uint32_t n, float** data ) :
-      t_(threads), n_(n) {
+  Refinement(uint32_t threads, uint32_t n, const Dataset &data, 
+      const RankSpace *ranks = NULL, const bool soa = false, 
+      const uint32_t intervals = 0 ) :
+      t_(threads), n_(n), ranks_(ranks), soa_(soa) {
 
     omp_set_num_threads(threads);
     result_.reserve(1024);
     data_ = NULL;
+    owns_data_ = false;
+    
+    intervals_ = ( intervals == 0 ? REFINEMENT_MAX_INTERVALS : intervals );
+    intervals_ = std::max( 2u, std::min( intervals_, REFINEMENT_MAX_INTERVALS ) );
+    while( intervals_ > 2 && grid_size( intervals_ ) > REFINEMENT_MAX_CELLS ) { --intervals_; }
+    num_cells_ = grid_size( intervals_ );
+    if( intervals != 0 && intervals != intervals_ ) {
+      fprintf( stderr, "Warning: clipped %u grid intervals per dimension to %u "
+        "(limits: 2 to %u intervals, %u cells)\n", intervals, intervals_, 
+        REFINEMENT_MAX_INTERVALS, REFINEMENT_MAX_CELLS );
+    }
   }
 
-	~Refinement() { }
+	~Refinement() { if( owns_data_ ) { delete[] data_; } }
   
   /**
    * Initializes the TKDQ solver with a new dataset.
-   * @param data The flat array of floats corresponding to the 
-   * input data.
+   * @param data The input dataset.
    * @post Populates the internal data structures of this Naive 
    * TKDQ solver to reflect the dataset provided.
    */
-  void Init( float** data );
+  void Init( const Dataset &data );
+
+  /**
+   * Initializes the TKDQ solver by adopting the dataset in place, if 
+   * possible, rather than copying it.
+   * @param data The input dataset, which is consumed if adopted.
+   * @post As Init(), but without allocating or copying tuples if the 
+   * rows of data are laid out as PTuple< dims >.
+   */
+  void InitInPlace( Dataset &data );
+
+  /**
+   * Initializes the TKDQ solver from a block of a dataset that is still 
+   * being loaded.
+   * @see TKDQ_Solver::InitBlock()
+   */
+  void BeginInit( const Dataset &data );
+  void InitBlock( const Dataset &data, const uint32_t begin, const uint32_t end );
+  void FinishInit( const Dataset &data );
 
 	std::vector< uint32_t > Execute( const uint32_t k );
 
@@ -74,11 +139,70 @@ protected:
   // protected data members:
   uint32_t n_; /**< The number of points in the dataset. */
   const uint32_t t_; /**< The number of threads with which the solution should be obtained. */
-  PTuple< dims > *data_; /**< The internal representation of the dataset. */
+  PTuple< dims, V > *data_; /**< The internal representation of the dataset. */
+  const RankSpace *ranks_; /**< The rank space of the dataset, if V is rank_t */
+  bool owns_data_; /**< True if data_ was allocated (rather than adopted) */
+  const bool soa_; /**< True if the tiled (SoA) kernels should be used */
+  SoATiles< dims, V > tiles_; /**< Tiled copy of data_ in cell order, if soa_ */
   std::vector< uint32_t > result_; /**< The vector that will contain the result point ids */
 
 private:
 
+	/**
+	 * Returns the number of cells in a grid with the given number of 
+	 * intervals per dimension.
+	 */
+	static uint64_t grid_size( const uint32_t intervals ) {
+		uint64_t size = 1;
+		for( uint32_t d = 0; d < dims; ++d ) { size *= intervals; }
+		return size;
+	}
+	
+	/**
+	 * Splits every dimension at the quantiles of the data and assigns each 
+	 * point to its grid cell.
+	 * @post splits_ and cell_coords_ are populated, as is the partition 
+	 * attribute of every point.
+	 */
+	void build_grid();
+	
+	/**
+	 * Returns true if cell a lies in no higher interval than cell b in any 
+	 * dimension, i.e., if points of a may dominate points of b.
+	 */
+	bool weakly_below( const uint32_t a, const uint32_t b ) const {
+		if( intervals_ == 2 ) { return ( a & b ) == a; } // cells are bitmasks
+		const uint8_t *ca = &cell_coords_[ a * dims ], *cb = &cell_coords_[ b * dims ];
+		for( uint32_t d = 0; d < dims; ++d ) {
+			if( ca[ d ] > cb[ d ] ) { return false; }
+		}
+		return true;
+	}
+	
+	/**
+	 * Returns true if cell a lies in a lower interval than cell b in every 
+	 * dimension, i.e., if every point of a dominates every point of b.
+	 */
+	bool strictly_below( const uint32_t a, const uint32_t b ) const {
+		if( intervals_ == 2 ) { return a == 0 && b == num_cells_ - 1; }
+		const uint8_t *ca = &cell_coords_[ a * dims ], *cb = &cell_coords_[ b * dims ];
+		for( uint32_t d = 0; d < dims; ++d ) {
+			if( ca[ d ] >= cb[ d ] ) { return false; }
+		}
+		return true;
+	}
+
+	/**
+	 * Replaces the count of every cell by the sum of the counts of all the 
+	 * cells weakly above (or below) it: the multi-dimensional suffix (prefix) 
+	 * sums over the grid, which for two intervals per dimension are the 
+	 * sums over supersets (subsets) of the cell's bitmask, i.e., the zeta 
+	 * transform. Takes O(dims * num_cells_) additions.
+	 * @param sums The count of each cell, which are overwritten by the sums.
+	 * @param above True for the sums of the cells above, false for below.
+	 */
+	void sum_over_cells( std::vector< uint32_t > &sums, const bool above ) const;
+	
 	/**
 	 * Conducts the counting pass of the Refinement algorithm.
 	 * @param k The number of points that should eventually be output by the 
@@ -87,7 +211,8 @@ private:
 	 * contain TKDQ points.
 	 * @post grid_cell_bounds is populated with upper bounds for each cell i,
 	 * corresponding to the cell counts of all other cells partially or fully 
-	 * dominated by cell i.
+	 * dominated by cell i, and with lower bounds, corresponding to those of 
+	 * the cells fully dominated by cell i.
 	 */
 	uint32_t counting_pass( const uint32_t k );
 	
@@ -99,15 +224,22 @@ private:
 	 * gamma is most certainly *not* a candidate TKDQ point.
 	 * @param k The number of points that should eventually be output by the 
 	 * TKDQ solver.
-	 * @post Modifies the candidates_ set for unpruned grid cells.
+	 * @post Modifies the candidates_ set for unpruned grid cells. The sets are 
+	 * the same as those of a serial pass over the points in cell order, for 
+	 * any number of threads.
 	 */ 
 	void coarse_grained_filter( const uint32_t gamma, const uint32_t k );
 		
 	/**
 	 * Conducts the final refinement pass (Algorithm 7) of the Refinement 
 	 * algorithm in which scores are actually calculated for points.
+	 * The candidates are scored best-first, in decreasing order of the upper 
+	 * bound of their cell, against the k'th best score found so far by any 
+	 * thread: a candidate whose bound falls below it is skipped, and one 
+	 * whose scan can no longer reach it is abandoned.
 	 * @post The score attribute is updated for data points that were 
-	 * previously denoted as candidates.
+	 * previously denoted as candidates, except that those skipped or 
+	 * abandoned (which cannot be among the top-k) keep a score of 0.
 	 * @note This is *not* a correct implementation of Algorithm 7 in the sense 
 	 * of matching the pseudocode. Algorithm 7 is designed to pick a point p' and  
 	 * update the score for every point dominating p'. This is not conducive to 
@@ -118,8 +250,21 @@ private:
 	 * would expect this implementation here to also make better use of cache. We 
 	 * found this (rather than the "correct") approach to be faster in our ICDE and 
 	 * PVLDB parallel skyline papers.
+	 * @param points The block on which dominated points are counted (see 
+	 * count_dominated()): data_ itself, or tiles_ built from it.
+	 * @param k The number of points that should eventually be output by the 
+	 * TKDQ solver.
+	 */
+	template< typename Block >
+	void refinement_pass( const Block &points, const uint32_t k );
+	
+	/**
+	 * Returns the ranges of the points that the points of a cell may, but 
+	 * need not, dominate: those of the cells weakly but not strictly above 
+	 * it, looked up in directory_, with abutting ranges merged.
+	 * @pre counting_pass() has been called.
 	 */
-	void refinement_pass();
+	std::vector< CellRun > partially_above( const uint32_t cell ) const;
 	
 	/**
 	 * Returns the number of points that have so far survived as TKDQ candidates.
@@ -133,16 +278,21 @@ private:
 	 * a list of ordered point ids).
 	 * @param k The number of points that should be copied into the output vector.
 	 * @post Modifies the result_ member variable to know contain the solution that 
-	 * should be reported back to a user. Also, resorts the data as if it were 
-	 * STuple objects (i.e., by score then point id).
+	 * should be reported back to a user, selected by score then point id 
+	 * (see TopKByScore()) without sorting the data.
 	 */ 
 	void prepare_result( const uint32_t k );
 	
 	// private data members, only for computation of local methods to ease method signatures
-	std::array< Bounds, ( 1 << dims ) > grid_cell_bounds_; /**< Lower/upper bounds for each cell */
-	std::array< bool, ( 1 << dims ) > pruned_; /**< Indicates which grid cells have been pruned. */
-	std::array< CandidateSet, ( 1 << dims ) > candidates_; /**< Candidate points in each cell */
-	std::array< uint32_t, ( 1 << dims ) > cell_dom_by_counts_; /**< # points dominating each cell */
+	uint32_t intervals_; /**< The number of intervals per dimension of the grid */
+	uint32_t num_cells_; /**< The number of cells of the grid: intervals_^dims */
+	std::vector< V > splits_; /**< The intervals_ - 1 split points of each dimension, ascending */
+	std::vector< uint8_t > cell_coords_; /**< cell_coords_[ c * dims + d ] is the interval of cell c in dimension d */
+	std::vector< Bounds > grid_cell_bounds_; /**< Lower/upper bounds for each cell */
+	std::vector< uint8_t > pruned_; /**< Indicates which grid cells have been pruned. */
+	std::vector< CandidateSet > candidates_; /**< Candidate points in each cell */
+	std::vector< uint32_t > cell_dom_by_counts_; /**< # points dominating each cell */
+	std::vector< CellRun > directory_; /**< The run of the points of each cell (empty if none) */
 };
 
 #endif /* REFINEMENT_H_ */
@@ -9,14 +9,19 @@
 #include <testdriver.h>
 
 #include <cstdlib>
+#include <limits>
 #include <stdio.h>
 
 #include "naive/naive.h"
 #include "refinement/refinement.h"
 #include "partition_based/partition_based.h"
+#include "bitmap/bitmap.h"
 #include "util/utilities.h"
+#include "util/csv_loader.h"
+#include "util/binary_dataset.h"
 #include "util/timing.h"
 #include "util/mem_usage.h"
+#include "util/isa_dispatch.h"
 #include "common/tkdq_solver.h"
 //#include "util/papi_counting.h"
 
@@ -25,17 +30,30 @@
  * Returns a templated version of a Naive TKDQ solver.
  */
 TKDQ_Solver* new_Naive( uint32_t t, uint32_t n, uint32_t d, 
-	float **data ) {
-
-	if( d == 2 ) { return new Naive< 2 >( t, n, data ); }
-	else if( d == 3 ) { return new Naive< 3 >( t, n, data ); }
-	else if( d == 4 ) { return new Naive< 4 >( t, n, data ); }
-	else if( d == 5 ) { return new Naive< 5 >( t, n, data ); }
-	else if( d == 6 ) { return new Naive< 6 >( t, n, data ); }
-	else if( d == 7 ) { return new Naive< 7 >( t, n, data ); }
-	else if( d == 8 ) { return new Naive< 8 >( t, n, data ); }
-	else if( d == 9 ) { return new Naive< 9 >( t, n, data ); }
-	else if( d == 10 ) { return new Naive< 10 >( t, n, data ); }
+	const Dataset &data, const RankSpace *ranks, const bool soa ) {
+
+	if( ranks != NULL ) {
+		if( d == 2 ) { return new Naive< 2, rank_t >( t, n, data, ranks, soa ); }
+		else if( d == 3 ) { return new Naive< 3, rank_t >( t, n, data, ranks, soa ); }
+		else if( d == 4 ) { return new Naive< 4, rank_t >( t, n, data, ranks, soa ); }
+		else if( d == 5 ) { return new Naive< 5, rank_t >( t, n, data, ranks, soa ); }
+		else if( d == 6 ) { return new Naive< 6, rank_t >( t, n, data, ranks, soa ); }
+		else if( d == 7 ) { return new Naive< 7, rank_t >( t, n, data, ranks, soa ); }
+		else if( d == 8 ) { return new Naive< 8, rank_t >( t, n, data, ranks, soa ); }
+		else if( d == 9 ) { return new Naive< 9, rank_t >( t, n, data, ranks, soa ); }
+		else if( d == 10 ) { return new Naive< 10, rank_t >( t, n, data, ranks, soa ); }
+		return NULL; //unsupported dimensionality.
+	}
+
+	if( d == 2 ) { return new Naive< 2 >( t, n, data, NULL, soa ); }
+	else if( d == 3 ) { return new Naive< 3 >( t, n, data, NULL, soa ); }
+	else if( d == 4 ) { return new Naive< 4 >( t, n, data, NULL, soa ); }
+	else if( d == 5 ) { return new Naive< 5 >( t, n, data, NULL, soa ); }
+	else if( d == 6 ) { return new Naive< 6 >( t, n, data, NULL, soa ); }
+	else if( d == 7 ) { return new Naive< 7 >( t, n, data, NULL, soa ); }
+	else if( d == 8 ) { return new Naive< 8 >( t, n, data, NULL, soa ); }
+	else if( d == 9 ) { return new Naive< 9 >( t, n, data, NULL, soa ); }
+	else if( d == 10 ) { return new Naive< 10 >( t, n, data, NULL, soa ); }
 	
 	return NULL; //unsupported dimensionality.
 }
@@ -45,17 +63,30 @@ TKDQ_Solver* new_Naive( uint32_t t, uint32_t n, uint32_t d,
  * Returns a templated version of a Refinement TKDQ solver.
  */
 TKDQ_Solver* new_Refinement( uint32_t t, uint32_t n, uint32_t d, 
-	float **data ) {
-
-	if( d == 2 ) { return new Refinement< 2 >( t, n, data ); }
-	else if( d == 3 ) { return new Refinement< 3 >( t, n, data ); }
-	else if( d == 4 ) { return new Refinement< 4 >( t, n, data ); }
-	else if( d == 5 ) { return new Refinement< 5 >( t, n, data ); }
-	else if( d == 6 ) { return new Refinement< 6 >( t, n, data ); }
-	else if( d == 7 ) { return new Refinement< 7 >( t, n, data ); }
-	else if( d == 8 ) { return new Refinement< 8 >( t, n, data ); }
-	else if( d == 9 ) { return new Refinement< 9 >( t, n, data ); }
-	else if( d == 10 ) { return new Refinement< 10 >( t, n, data ); }
+	const Dataset &data, const RankSpace *ranks, const bool soa, const uint32_t grid ) {
+
+	if( ranks != NULL ) {
+		if( d == 2 ) { return new Refinement< 2, rank_t >( t, n, data, ranks, soa, grid ); }
+		else if( d == 3 ) { return new Refinement< 3, rank_t >( t, n, data, ranks, soa, grid ); }
+		else if( d == 4 ) { return new Refinement< 4, rank_t >( t, n, data, ranks, soa, grid ); }
+		else if( d == 5 ) { return new Refinement< 5, rank_t >( t, n, data, ranks, soa, grid ); }
+		else if( d == 6 ) { return new Refinement< 6, rank_t >( t, n, data, ranks, soa, grid ); }
+		else if( d == 7 ) { return new Refinement< 7, rank_t >( t, n, data, ranks, soa, grid ); }
+		else if( d == 8 ) { return new Refinement< 8, rank_t >( t, n, data, ranks, soa, grid ); }
+		else if( d == 9 ) { return new Refinement< 9, rank_t >( t, n, data, ranks, soa, grid ); }
+		else if( d == 10 ) { return new Refinement< 10, rank_t >( t, n, data, ranks, soa, grid ); }
+		return NULL; //unsupported dimensionality.
+	}
+
+	if( d == 2 ) { return new Refinement< 2 >( t, n, data, NULL, soa, grid ); }
+	else if( d == 3 ) { return new Refinement< 3 >( t, n, data, NULL, soa, grid ); }
+	else if( d == 4 ) { return new Refinement< 4 >( t, n, data, NULL, soa, grid ); }
+	else if( d == 5 ) { return new Refinement< 5 >( t, n, data, NULL, soa, grid ); }
+	else if( d == 6 ) { return new Refinement< 6 >( t, n, data, NULL, soa, grid ); }
+	else if( d == 7 ) { return new Refinement< 7 >( t, n, data, NULL, soa, grid ); }
+	else if( d == 8 ) { return new Refinement< 8 >( t, n, data, NULL, soa, grid ); }
+	else if( d == 9 ) { return new Refinement< 9 >( t, n, data, NULL, soa, grid ); }
+	else if( d == 10 ) { return new Refinement< 10 >( t, n, data, NULL, soa, grid ); }
 	
 	return NULL; //unsupported dimensionality.
 }
@@ -65,7 +96,20 @@ TKDQ_Solver* new_Refinement( uint32_t t, uint32_t n, uint32_t d,
  * Returns a templated version of a Partition TKDQ solver.
  */
 TKDQ_Solver* new_PartitionBased( uint32_t t, uint32_t n, uint32_t d, 
-	float **data ) {
+	const Dataset &data, const RankSpace *ranks ) {
+
+	if( ranks != NULL ) {
+		if( d == 2 ) { return new PartitionBased< 2, rank_t >( t, n, data, ranks ); }
+		else if( d == 3 ) { return new PartitionBased< 3, rank_t >( t, n, data, ranks ); }
+		else if( d == 4 ) { return new PartitionBased< 4, rank_t >( t, n, data, ranks ); }
+		else if( d == 5 ) { return new PartitionBased< 5, rank_t >( t, n, data, ranks ); }
+		else if( d == 6 ) { return new PartitionBased< 6, rank_t >( t, n, data, ranks ); }
+		else if( d == 7 ) { return new PartitionBased< 7, rank_t >( t, n, data, ranks ); }
+		else if( d == 8 ) { return new PartitionBased< 8, rank_t >( t, n, data, ranks ); }
+		else if( d == 9 ) { return new PartitionBased< 9, rank_t >( t, n, data, ranks ); }
+		else if( d == 10 ) { return new PartitionBased< 10, rank_t >( t, n, data, ranks ); }
+		return NULL; //unsupported dimensionality.
+	}
 
 	if( d == 2 ) { return new PartitionBased< 2 >( t, n, data ); }
 	else if( d == 3 ) { return new PartitionBased< 3 >( t, n, data ); }
@@ -81,11 +125,57 @@ TKDQ_Solver* new_PartitionBased( uint32_t t, uint32_t n, uint32_t d,
 }
 
 
+/**
+ * Returns a templated version of a Bitmap TKDQ solver.
+ */
+TKDQ_Solver* new_Bitmap( uint32_t t, uint32_t n, uint32_t d, 
+	const Dataset &data, const RankSpace *ranks ) {
+
+	if( ranks != NULL ) {
+		if( d == 2 ) { return new Bitmap< 2, rank_t >( t, n, data, ranks ); }
+		else if( d == 3 ) { return new Bitmap< 3, rank_t >( t, n, data, ranks ); }
+		else if( d == 4 ) { return new Bitmap< 4, rank_t >( t, n, data, ranks ); }
+		else if( d == 5 ) { return new Bitmap< 5, rank_t >( t, n, data, ranks ); }
+		else if( d == 6 ) { return new Bitmap< 6, rank_t >( t, n, data, ranks ); }
+		else if( d == 7 ) { return new Bitmap< 7, rank_t >( t, n, data, ranks ); }
+		else if( d == 8 ) { return new Bitmap< 8, rank_t >( t, n, data, ranks ); }
+		else if( d == 9 ) { return new Bitmap< 9, rank_t >( t, n, data, ranks ); }
+		else if( d == 10 ) { return new Bitmap< 10, rank_t >( t, n, data, ranks ); }
+		else if( d == 11 ) { return new Bitmap< 11, rank_t >( t, n, data, ranks ); }
+		else if( d == 12 ) { return new Bitmap< 12, rank_t >( t, n, data, ranks ); }
+		else if( d == 13 ) { return new Bitmap< 13, rank_t >( t, n, data, ranks ); }
+		else if( d == 14 ) { return new Bitmap< 14, rank_t >( t, n, data, ranks ); }
+		else if( d == 15 ) { return new Bitmap< 15, rank_t >( t, n, data, ranks ); }
+		else if( d == 16 ) { return new Bitmap< 16, rank_t >( t, n, data, ranks ); }
+		return NULL; //unsupported dimensionality.
+	}
+
+	if( d == 2 ) { return new Bitmap< 2 >( t, n, data ); }
+	else if( d == 3 ) { return new Bitmap< 3 >( t, n, data ); }
+	else if( d == 4 ) { return new Bitmap< 4 >( t, n, data ); }
+	else if( d == 5 ) { return new Bitmap< 5 >( t, n, data ); }
+	else if( d == 6 ) { return new Bitmap< 6 >( t, n, data ); }
+	else if( d == 7 ) { return new Bitmap< 7 >( t, n, data ); }
+	else if( d == 8 ) { return new Bitmap< 8 >( t, n, data ); }
+	else if( d == 9 ) { return new Bitmap< 9 >( t, n, data ); }
+	else if( d == 10 ) { return new Bitmap< 10 >( t, n, data ); }
+	else if( d == 11 ) { return new Bitmap< 11 >( t, n, data ); }
+	else if( d == 12 ) { return new Bitmap< 12 >( t, n, data ); }
+	else if( d == 13 ) { return new Bitmap< 13 >( t, n, data ); }
+	else if( d == 14 ) { return new Bitmap< 14 >( t, n, data ); }
+	else if( d == 15 ) { return new Bitmap< 15 >( t, n, data ); }
+	else if( d == 16 ) { return new Bitmap< 16 >( t, n, data ); }
+	
+	return NULL; //unsupported dimensionality.
+}
+
+
 /**
  * Create multi-threaded TKDQ solver
  */
 TKDQ_Solver* createMTSkyline(string alg_name, const uint32_t n, const uint32_t d,
-    float** data, uint32_t threads ) {
+    const Dataset &data, uint32_t threads, const RankSpace *ranks,
+    const bool soa, const uint32_t grid ) {
     
   /*
   uint32_t papi_mode_val = PAPI_MODE_OFF;
@@ -95,32 +185,159 @@ TKDQ_Solver* createMTSkyline(string alg_name, const uint32_t n, const uint32_t d
   */
     
   if ( alg_name.compare( alg_naive ) == 0 ) {
-    return new_Naive( threads, n, d, data );
+    return new_Naive( threads, n, d, data, ranks, soa );
   }
   else if ( alg_name.compare( alg_refinement ) == 0 ) {
-    return new_Refinement( threads, n, d, data );
+    return new_Refinement( threads, n, d, data, ranks, soa, grid );
   }
   else if ( alg_name.compare( alg_partition ) == 0 ) {
-    return new_PartitionBased( threads, n, d, data );
+    return new_PartitionBased( threads, n, d, data, ranks );
+  }
+  else if ( alg_name.compare( alg_bitmap ) == 0 ) {
+    return new_Bitmap( threads, n, d, data, ranks );
   }
 
   return NULL;
 }
 
+/**
+ * Creates the solver for the first run as soon as the loader knows the
+ * size of the dataset, and then hands it every block of rows as soon as
+ * it has been parsed, so that its initialization overlaps with parsing.
+ */
+class PipelinedInit : public RowBlockConsumer {
+
+public:
+
+  PipelinedInit(const Config &cfg) : cfg_(cfg), solver(NULL) { }
+
+  void Begin(const Dataset &data) {
+    solver = createMTSkyline(cfg_.algo[0], data.num_points(), data.num_dims(),
+        data, atoi(cfg_.threads[0].c_str()), NULL, cfg_.soa, cfg_.grid);
+    if (solver != NULL) {
+      solver->BeginInit(data);
+    }
+  }
+
+  void Consume(const Dataset &data, const uint32_t begin, const uint32_t end) {
+    if (solver != NULL) {
+      solver->InitBlock(data, begin, end);
+    }
+  }
+
+  TKDQ_Solver *solver; /**< The solver for the first run, once created */
+
+private:
+  const Config &cfg_;
+};
+
+/**
+ * Reads the input file: a binary dataset is mapped (and, if row-major,
+ * used in place); anything else is parsed as a CSV file. If requested,
+ * the values are normalized with the bounds in the binary header or with
+ * those collected while parsing. If requested, the dimensions are then
+ * permuted by selectivity (see dim_order.h). If requested, the rank space of the
+ * values is built, unless some dimension has too many distinct values
+ * for rank_t, in which case the solvers run on floats. If a consumer is
+ * given, it receives the rows as they are loaded.
+ */
+void ReadInput(const Config &cfg, InputData &in,
+    RowBlockConsumer *consumer = NULL) {
+  const char *fname = cfg.input_fname.c_str();
+  in.is_mapped = IsBinaryDataset(fname);
+  if (in.is_mapped) {
+    MapBinaryDataset(fname, in.mapped);
+    const BinaryHeader header = in.mapped.header;
+    if (in.mapped.header.layout == LAYOUT_ROW) {
+      in.data = new Dataset(in.mapped.data, in.mapped.header.n,
+          in.mapped.header.d);
+    } else {
+      in.data = TransposeToRows(in.mapped, cfg.huge_pages);
+      UnmapBinaryDataset(in.mapped);
+      in.is_mapped = false;
+    }
+    if (cfg.normalize) {
+      in.data->Normalize(header.min, header.max);
+    }
+    if (consumer != NULL) { // nothing to overlap with: it is already loaded
+      consumer->Begin(*in.data);
+      consumer->Consume(*in.data, 0, in.data->num_points());
+    }
+  } else {
+    in.data = LoadCSV(fname, false, cfg.normalize, cfg.huge_pages,
+        cfg.in_place, consumer);
+  }
+
+  if (cfg.reorder_dims) {
+    in.dim_order = EstimateDimensionOrder(*in.data);
+    in.data->PermuteDimensions(in.dim_order.order.data());
+  }
+
+  in.ranks = NULL;
+  if (cfg.rank_space) {
+    in.ranks = new RankSpace(*in.data);
+    if (in.ranks->max_ranks() > (uint32_t) std::numeric_limits< rank_t >::max() + 1) {
+      fprintf(stderr, "Warning: %u distinct values do not fit in rank space; "
+          "using floats\n", in.ranks->max_ranks());
+      delete in.ranks;
+      in.ranks = NULL;
+    }
+  }
+}
+
+/**
+ * Returns true if (algorithm a, thread count t) is the last run of cfg.
+ */
+bool IsLastRun(const Config &cfg, const uint32_t a, const uint32_t t) {
+  return a + 1 == cfg.algo.size() && t + 1 == cfg.threads.size();
+}
+
+/**
+ * Releases everything acquired by ReadInput().
+ */
+void ReleaseInput(InputData &in) {
+  delete in.ranks;
+  delete in.data;
+  if (in.is_mapped) {
+    UnmapBinaryDataset(in.mapped);
+  }
+}
+
+/**
+ * Converts the input file to a binary dataset and writes it to
+ * cfg.convert_fname.
+ */
+int doConversion(Config &cfg) {
+  InputData in;
+  ReadInput(cfg, in);
+  const bool ok = WriteBinaryDataset(cfg.convert_fname.c_str(),
+      in.data->values(), in.data->num_points(), in.data->num_dims(),
+      cfg.convert_layout);
+  if (ok) {
+    printf("Wrote %u points (d=%u) to '%s'\n", in.data->num_points(),
+        in.data->num_dims(), cfg.convert_fname.c_str());
+  } else {
+    fprintf(stderr, "Can't write binary dataset '%s'\n",
+        cfg.convert_fname.c_str());
+  }
+  ReleaseInput(in);
+  return ok ? 0 : 1;
+}
+
 void doPerformanceTest(Config &cfg) {
-  vector<vector<float> > vvf = read_data(cfg.input_fname.c_str(), false, false);
-  const uint32_t n = vvf.size();
-  const uint32_t d = vvf.front().size();
+  const long load_start = GetTime();
+  InputData in;
+  PipelinedInit pipeline(cfg);
+  ReadInput(cfg, in, cfg.pipeline ? &pipeline : NULL);
+  const Dataset &data = *in.data;
+  const uint32_t n = data.num_points();
+  const uint32_t d = data.num_dims();
 #if COUNT_DT==1
   extern uint64_t dt_count;
   extern uint64_t dt_count_dom;
   extern uint64_t dt_count_incomp;
 #endif
 
-  float** data = AllocateDoubleArray(n, d);
-  redistribute_data(vvf, data);
-  vvf.clear();
-
   long msec = 0;
   std::vector< std::vector< uint32_t > > results;
 
@@ -155,12 +372,23 @@ void doPerformanceTest(Config &cfg) {
 			dt_count_incomp = 0;
 #endif
 			const uint32_t num_threads = atoi(cfg.threads[t].c_str());
-			TKDQ_Solver* solver = createMTSkyline( cfg.algo[a], n, d, data,
-					num_threads );
+			const bool pipelined = (a == 0 && t == 0 && pipeline.solver != NULL);
+			TKDQ_Solver* solver = pipelined ? pipeline.solver
+					: createMTSkyline( cfg.algo[a], n, d, data, num_threads, in.ranks,
+							cfg.soa, cfg.grid );
 			if ( solver != NULL) {
 				msec = GetTime();
-				// initialization:
-				solver->Init(data);
+				// initialization (the last run may consume the dataset; a
+				// pipelined run has been initialized while loading, so it is
+				// timed end-to-end, from the start of loading):
+				if (pipelined) {
+					msec = load_start;
+					solver->FinishInit(data);
+				} else if (cfg.in_place && IsLastRun(cfg, a, t)) {
+					solver->InitInPlace(*in.data);
+				} else {
+					solver->Init(data);
+				}
 
 				// skyline computation:
 				std::vector< uint32_t > res = solver->Execute( cfg.k );
@@ -178,13 +406,15 @@ void doPerformanceTest(Config &cfg) {
 
   if ( results.size() > 1 ) {
     for (uint32_t i = 1; i < results.size(); ++i) {
-      if ( !CompareTwoLists( results[0], results[i], cfg.k, true ) ) {
+      if ( !CompareTwoLists( results[0], results[i], std::min(cfg.k, n), true ) ) {
         fprintf( stderr, "ERROR: Skylines of run #%u (|sky|=%lu) "
             "and #%u (|sky|=%lu) do not match!!!\n", 0, results[0].size(), i,
             results[i].size());
       }
     }
   }
+
+  ReleaseInput(in);
 }
 
 void doVerboseTest(Config &cfg) {
@@ -199,17 +429,26 @@ void doVerboseTest(Config &cfg) {
 
   printf("Input reading (%s)\n", cfg.input_fname.c_str());
   msec = GetTime();
-  vector<vector<float> > vvf = read_data(cfg.input_fname.c_str(), false, false);
-  const uint32_t n = vvf.size();
-  const uint32_t d = vvf.front().size();
+  const long load_start = msec;
+  InputData in;
+  PipelinedInit pipeline(cfg);
+  ReadInput(cfg, in, cfg.pipeline ? &pipeline : NULL);
+  const Dataset &data = *in.data;
+  const uint32_t n = data.num_points();
+  const uint32_t d = data.num_dims();
   msec = GetTime() - msec;
   printf(" d=%d;\n n=%d\n", d, n);
   printf(" duration: %ld msec\n", msec);
-
-  float** data = AllocateDoubleArray(n, d);
-  redistribute_data(vvf, data);
-  vvf.clear();
-
+  if (cfg.reorder_dims) {
+    const DimensionOrder &order = in.dim_order;
+    printf(" dimension order:");
+    for (uint32_t j = 0; j < order.order.size(); ++j) {
+      printf(" %u", order.order[j]);
+    }
+    printf("\n dims scanned per DT (est.): %.2f -> %.2f (%.1f %% fewer)\n",
+        order.dims_per_test_before, order.dims_per_test_after,
+        100.0 * (1 - order.dims_per_test_after / order.dims_per_test_before));
+  }
 
   for (uint32_t a = 0; a < cfg.algo.size(); ++a) {
 		for (uint32_t t = 0; t < cfg.threads.size(); ++t) {
@@ -219,13 +458,24 @@ void doVerboseTest(Config &cfg) {
 			dt_count_incomp = 0;
 #endif
 			const uint32_t num_threads = atoi(cfg.threads[t].c_str());
-			TKDQ_Solver* solver = createMTSkyline(cfg.algo[a], n, d, data,
-					num_threads );
+			const bool pipelined = (a == 0 && t == 0 && pipeline.solver != NULL);
+			TKDQ_Solver* solver = pipelined ? pipeline.solver
+					: createMTSkyline(cfg.algo[a], n, d, data, num_threads, in.ranks,
+							cfg.soa, cfg.grid );
 			if ( solver != NULL) {
-				printf("#%u: %s (t=%u)\n", a, cfg.algo[a].c_str(), num_threads);
+				printf("#%u: %s (t=%u)%s\n", a, cfg.algo[a].c_str(), num_threads,
+						pipelined ? " pipelined with input reading" : "");
 				msec = GetTime();
-				// initialization:
-				solver->Init(data);
+				// initialization (the last run may consume the dataset; a
+				// pipelined run is timed from the start of input reading):
+				if (pipelined) {
+					msec = load_start;
+					solver->FinishInit(data);
+				} else if (cfg.in_place && IsLastRun(cfg, a, t)) {
+					solver->InitInPlace(*in.data);
+				} else {
+					solver->Init(data);
+				}
 				long elapsed_msec = GetTime() - msec;
 				printf(" init: %ld msec \n", elapsed_msec);
 
@@ -274,7 +524,7 @@ void doVerboseTest(Config &cfg) {
   if ( results.size() > 1 ) {
     bool correct = true;
     for (uint32_t i = 1; i < results.size(); ++i) {
-      if ( !CompareTwoLists( results[0], results[i], cfg.k, true ) ) {
+      if ( !CompareTwoLists( results[0], results[i], std::min(cfg.k, n), true ) ) {
         fprintf( stderr, "ERROR: Output of run #%u (|tkdq|=%lu) and "
             "#%u (|tkdq|=%lu) do not match!!!\n", 0, results[0].size(), i,
             results[i].size());
@@ -291,14 +541,14 @@ void doVerboseTest(Config &cfg) {
     printf(" |skyline| = %lu (%.2f %%)\n", results[0].size(),
         results[0].size() * 100.0 / n);
 
-  FreeDoubleArray(n, data);
+  ReleaseInput(in);
 }
 
 void printUsage() {
   std::cout << "\nParallelTKDQ - a benchmark for skyline algorithms" << std::endl << std::endl;
   std::cout << "USAGE: ./ParallelTKDQ -f filename [-t \"num_threads\"] [-v]" << std::endl;
   std::cout << "       [-a size] [-q size]" << std::endl;
-  std::cout << " -f: input filename\n" << std::endl;
+  std::cout << " -f: input filename (CSV or binary dataset)\n" << std::endl;
   std::cout << " -t: run with num_threads, e.g., \"1 2 4\" (default \"4\")" << std::endl;
   std::cout << "     Note: used only with multi-threaded algorithms" << std::endl;
   std::cout << " -a: algorithms to run, by default runs all" << std::endl;
@@ -306,9 +556,30 @@ void printUsage() {
   std::cout << " -p: papi counters to monitor (none, branch, cache, or throughput)" << std::endl;
   std::cout << " -a: alpha block size (q_accum)" << std::endl;
   std::cout << " -k: number of points to return" << std::endl;
-  std::cout << " -v: verbose mode (don't use for performance experiments!)" << std::endl << std::endl;
+  std::cout << " -v: verbose mode (don't use for performance experiments!)" << std::endl;
+  std::cout << " -c: convert the input file to a binary dataset with this name and exit" << std::endl;
+  std::cout << " -l: layout of the binary dataset written by -c (row or column, default row)" << std::endl;
+  std::cout << " -H: back the dataset with transparent huge pages" << std::endl;
+  std::cout << " -n: normalize every dimension of the input to [0,1] while loading," << std::endl;
+  std::cout << "     so that raw (e.g., production) data can be fed in directly" << std::endl;
+  std::cout << " -z: lay out the dataset as solver tuples and let the last run" << std::endl;
+  std::cout << "     adopt it in place instead of copying it (halves peak memory)" << std::endl;
+  std::cout << " -r: run the solvers on 16-bit per-dimension ranks instead of floats" << std::endl;
+  std::cout << "     (same results; falls back to floats if a dimension has > 65536 values)" << std::endl;
+  std::cout << " -s: stream the input into the first run's Init as it is parsed and time" << std::endl;
+  std::cout << "     that run end-to-end (ignored with -r and -D, which need all values first;" << std::endl;
+  std::cout << "     with -n, the rows are only handed over once all are parsed and rescaled)" << std::endl;
+  std::cout << " -D: permute the dimensions so that dominance tests scan the most selective" << std::endl;
+  std::cout << "     first (same results; with -v, reports the estimated savings)" << std::endl;
+  std::cout << " -T: let naive and refinement test one point against a tile of 8 points" << std::endl;
+  std::cout << "     at a time, on a structure-of-arrays copy of the data" << std::endl;
+  std::cout << " -g: intervals per dimension of refinement's grid (default: as many as" << std::endl;
+  std::cout << "     fit in " << REFINEMENT_MAX_CELLS << " cells; larger values are clipped to that budget" << std::endl;
+  std::cout << "     and to [2, " << REFINEMENT_MAX_INTERVALS << "], with a warning)" << std::endl;
+  std::cout << " -I: instruction set of the dominance tests (scalar, sse4, avx2, or avx512;" << std::endl;
+  std::cout << "     default: the best that the CPU supports)" << std::endl << std::endl;
   std::cout << "Example: " ;
-  std::cout << "./ParallelTKDQ -k 5 -f ../workloads/house.csv -s \"partition naive\"" << std::endl << std::endl;
+  std::cout << "./ParallelTKDQ -k 5 -f ../workloads/house.csv -a \"partition naive\"" << std::endl << std::endl;
 }
 
 int main(int argc, char** argv) {
@@ -318,12 +589,23 @@ int main(int argc, char** argv) {
   string num_threads = "4";
   std::string k = "5";
   cfg.input_fname = ""; // "../workloads/house-U-6-127931.csv";
+  cfg.convert_fname = "";
+  cfg.convert_layout = LAYOUT_ROW;
+  cfg.huge_pages = false;
+  cfg.in_place = false;
+  cfg.normalize = false;
+  cfg.rank_space = false;
+  cfg.pipeline = false;
+  cfg.soa = false;
+  cfg.reorder_dims = false;
+  cfg.grid = 0; // i.e., automatic
+  cfg.isa = NUM_ISAS; // i.e., detect
   int index;
   int c;
 
   opterr = 0;
 
-  while ( ( c = getopt( argc, argv, "f:t:k:a:v:" ) ) != -1 ) {
+  while ( ( c = getopt( argc, argv, "f:t:k:a:v:c:l:HznrsTDg:I:" ) ) != -1 ) {
     switch ( c ) {
     case 'f':
       cfg.input_fname = string(optarg);
@@ -340,6 +622,51 @@ int main(int argc, char** argv) {
     case 't':
       num_threads = string(optarg);
       break;
+    case 'c':
+      cfg.convert_fname = string(optarg);
+      break;
+    case 'l':
+      if (string(optarg) == "row") {
+        cfg.convert_layout = LAYOUT_ROW;
+      } else if (string(optarg) == "column") {
+        cfg.convert_layout = LAYOUT_COLUMN;
+      } else {
+        fprintf( stderr, "Unknown layout `%s'.\n", optarg);
+        printUsage();
+        return 1;
+      }
+      break;
+    case 'H':
+      cfg.huge_pages = true;
+      break;
+    case 'z':
+      cfg.in_place = true;
+      break;
+    case 'n':
+      cfg.normalize = true;
+      break;
+    case 'r':
+      cfg.rank_space = true;
+      break;
+    case 's':
+      cfg.pipeline = true;
+      break;
+    case 'T':
+      cfg.soa = true;
+      break;
+    case 'D':
+      cfg.reorder_dims = true;
+      break;
+    case 'g':
+      cfg.grid = atoi(optarg);
+      break;
+    case 'I':
+      if (!ParseIsa(string(optarg), cfg.isa)) {
+        fprintf( stderr, "Unknown instruction set `%s'.\n", optarg);
+        printUsage();
+        return 1;
+      }
+      break;
     default:
       if ( isprint( optopt ) ) {
         fprintf( stderr, "Unknown option `-%c'.\n", optopt);
@@ -354,12 +681,49 @@ int main(int argc, char** argv) {
     return 1;
   }
 
+  // switch to the build for the best (or the requested) instruction set
+  const Isa supported = DetectIsa();
+  if (cfg.isa == NUM_ISAS) {
+    cfg.isa = supported;
+  } else if (cfg.isa > supported) {
+    fprintf(stderr, "Warning: this CPU does not support %s; using %s\n",
+        IsaName(cfg.isa), IsaName(supported));
+    cfg.isa = supported;
+  }
+  Isa dispatched = DispatchIsa(cfg.isa, argv);
+  if (dispatched == NUM_ISAS) {
+    if (BUILD_ISA > supported) {
+      fprintf(stderr, "Error: no %s (or less capable) build found next to this executable, "
+          "and this %s build needs instructions that this CPU lacks\n",
+          IsaName(cfg.isa), IsaName(BUILD_ISA));
+      return 1;
+    }
+    dispatched = BUILD_ISA;
+  }
+  if (dispatched != cfg.isa) {
+    fprintf(stderr, "Warning: no %s build found next to this executable; using %s\n",
+        IsaName(cfg.isa), IsaName(dispatched));
+    cfg.isa = dispatched;
+  }
+
   cfg.threads = my_split(num_threads, ' ');
   cfg.algo = my_split(algorithms, ' ');
   cfg.k = std::stoi(k);
 
+  if (!cfg.convert_fname.empty()) {
+    cfg.in_place = false; // the converter needs a dense layout
+    cfg.rank_space = false;
+    cfg.pipeline = false;
+    cfg.reorder_dims = false;
+    return doConversion(cfg);
+  }
+
+  if (cfg.rank_space || cfg.reorder_dims) {
+    cfg.pipeline = false; // ranks and orders can only be found once all values are in
+  }
+
   if (verbose) {
-    printf("Running in verbose (-v) mode\n");
+    printf("Running in verbose (-v) mode (%s)\n", IsaName(cfg.isa));
     doVerboseTest(cfg);
   } else {
     // Experiments for high performance
@@ -12,16 +12,44 @@
 #include <vector>
 #include <string>
 
+#include "common/dim_order.h"
+#include "common/rank_space.h"
+#include "util/binary_dataset.h"
+#include "util/isa_dispatch.h"
+
 const std::string alg_naive = "naive";
 const std::string alg_refinement = "refinement";
 const std::string alg_partition = "partition";
-const std::string alg_all = "naive refinement partition";
+const std::string alg_bitmap = "bitmap";
+const std::string alg_all = "naive refinement partition bitmap";
 
 typedef struct Config {
   std::string input_fname;
   std::vector< std::string > algo;
   std::vector< std::string > threads;
   uint32_t k;
+  std::string convert_fname; /**< If set, only convert input to this binary file */
+  BinaryLayout convert_layout; /**< Layout with which to write convert_fname */
+  bool huge_pages; /**< Back the dataset with transparent huge pages */
+  bool in_place; /**< Let the last solver adopt the dataset rather than copy it */
+  bool normalize; /**< Rescale every dimension of the input to [0,1] */
+  bool rank_space; /**< Run the solvers on rank_t tuples (see RankSpace) */
+  bool pipeline; /**< Overlap parsing with Init of the first run */
+  bool soa; /**< Use the tiled, structure-of-arrays kernels (see SoATiles) */
+  bool reorder_dims; /**< Permute the dimensions by selectivity (see dim_order.h) */
+  uint32_t grid; /**< Intervals per dimension of Refinement's grid (0: automatic) */
+  Isa isa; /**< The instruction set family of the dominance tests */
 } Config;
 
+/**
+ * The input dataset, however it was obtained.
+ */
+typedef struct InputData {
+  Dataset *data; /**< The dataset that is handed to the solvers */
+  bool is_mapped; /**< True if data wraps a mapped binary dataset */
+  MappedDataset mapped; /**< The mapping, if is_mapped */
+  RankSpace *ranks; /**< The rank space of data, or NULL to run on floats */
+  DimensionOrder dim_order; /**< The permutation applied to data, if any */
+} InputData;
+
 #endif /* TESTDRIVER_H_ */
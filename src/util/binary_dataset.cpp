@@ -0,0 +1,199 @@
+/**
+ * Implementation of the binary dataset format.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#include "util/binary_dataset.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#else
+#define omp_get_thread_num() 0
+#define omp_get_max_threads() 1
+#endif
+
+namespace {
+
+const uint64_t PAGE_SIZE = 4096; /**< Alignment of data_offset */
+
+/** Rounds x up to the next multiple of m. */
+inline uint64_t round_up( const uint64_t x, const uint64_t m ) {
+	return ( ( x + m - 1 ) / m ) * m;
+}
+
+/**
+ * Computes the per-dimension min and max of a row-major dataset
+ * with a per-thread reduction.
+ */
+void compute_bounds( const float *data, const uint32_t n, const uint32_t d,
+	float *min, float *max ) {
+
+	const uint32_t t = omp_get_max_threads();
+	std::vector< float > t_min( t * d ), t_max( t * d );
+	for( uint32_t i = 0; i < t; ++i ) {
+		for( uint32_t j = 0; j < d; ++j ) {
+			t_min[ i * d + j ] = data[ j ];
+			t_max[ i * d + j ] = data[ j ];
+		}
+	}
+
+#pragma omp parallel for
+	for( uint32_t i = 0; i < n; ++i ) {
+		float *my_min = &t_min[ omp_get_thread_num() * d ];
+		float *my_max = &t_max[ omp_get_thread_num() * d ];
+		const float *row = data + (uint64_t) i * d;
+		for( uint32_t j = 0; j < d; ++j ) {
+			if( row[ j ] < my_min[ j ] ) { my_min[ j ] = row[ j ]; }
+			if( row[ j ] > my_max[ j ] ) { my_max[ j ] = row[ j ]; }
+		}
+	}
+
+	for( uint32_t j = 0; j < d; ++j ) {
+		min[ j ] = t_min[ j ];
+		max[ j ] = t_max[ j ];
+		for( uint32_t i = 1; i < t; ++i ) {
+			if( t_min[ i * d + j ] < min[ j ] ) { min[ j ] = t_min[ i * d + j ]; }
+			if( t_max[ i * d + j ] > max[ j ] ) { max[ j ] = t_max[ i * d + j ]; }
+		}
+	}
+}
+
+} // namespace
+
+
+bool IsBinaryDataset( const char *filename ) {
+	FILE *f = fopen( filename, "rb" );
+	if( f == NULL ) { return false; }
+	char magic[ sizeof( BINARY_MAGIC ) ];
+	const bool is_binary = fread( magic, 1, sizeof( magic ), f ) == sizeof( magic )
+		&& memcmp( magic, BINARY_MAGIC, sizeof( magic ) ) == 0;
+	fclose( f );
+	return is_binary;
+}
+
+
+bool WriteBinaryDataset( const char *filename, const float *data,
+	const uint32_t n, const uint32_t d, const BinaryLayout layout ) {
+
+	if( d == 0 || d > BINARY_MAX_DIMS || n == 0 ) { return false; }
+
+	/* Populate the header. */
+	BinaryHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magic, BINARY_MAGIC, sizeof( BINARY_MAGIC ) );
+	header.version = BINARY_VERSION;
+	header.layout = layout;
+	header.n = n;
+	header.d = d;
+	header.alignment = BINARY_ALIGNMENT;
+	header.data_offset = round_up( sizeof( BinaryHeader ), PAGE_SIZE );
+	header.column_stride = ( layout == LAYOUT_COLUMN )
+		? round_up( n, BINARY_ALIGNMENT / sizeof( float ) ) : 0;
+	compute_bounds( data, n, d, header.min, header.max );
+
+	FILE *f = fopen( filename, "wb" );
+	if( f == NULL ) { return false; }
+	bool ok = fwrite( &header, sizeof( header ), 1, f ) == 1;
+
+	/* Pad up to the (page-aligned) start of the data. */
+	std::vector< char > padding( header.data_offset - sizeof( header ), 0 );
+	ok = ok && fwrite( padding.data(), 1, padding.size(), f ) == padding.size();
+
+	if( layout == LAYOUT_ROW ) {
+		ok = ok && fwrite( data, sizeof( float ), (uint64_t) n * d, f ) == (uint64_t) n * d;
+	}
+	else {
+		std::vector< float > column( header.column_stride, 0 );
+		for( uint32_t j = 0; ok && j < d; ++j ) {
+#pragma omp parallel for
+			for( uint32_t i = 0; i < n; ++i ) {
+				column[ i ] = data[ (uint64_t) i * d + j ];
+			}
+			ok = fwrite( column.data(), sizeof( float ), column.size(), f ) == column.size();
+		}
+	}
+
+	return ( fclose( f ) == 0 ) && ok;
+}
+
+
+void MapBinaryDataset( const char *filename, MappedDataset &ds ) {
+
+	const int fd = open( filename, O_RDONLY );
+	struct stat st;
+	if( fd < 0 || fstat( fd, &st ) != 0 ) {
+		printf( "Can't find '%s' file\n", filename );
+		exit( EXIT_FAILURE );
+	}
+	ds.length = st.st_size;
+	if( ds.length < sizeof( BinaryHeader ) ) {
+		printf( "'%s' is not a binary dataset\n", filename );
+		exit( EXIT_FAILURE );
+	}
+
+	ds.mapping = mmap( NULL, ds.length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+	close( fd );
+	if( ds.mapping == MAP_FAILED ) {
+		printf( "Can't map '%s' file\n", filename );
+		exit( EXIT_FAILURE );
+	}
+
+	/* Validate the header before trusting any of its fields. */
+	memcpy( &ds.header, ds.mapping, sizeof( BinaryHeader ) );
+	const BinaryHeader &h = ds.header;
+	if( memcmp( h.magic, BINARY_MAGIC, sizeof( BINARY_MAGIC ) ) != 0 ) {
+		printf( "'%s' is not a binary dataset\n", filename );
+		exit( EXIT_FAILURE );
+	}
+	if( h.version > BINARY_VERSION ) {
+		printf( "'%s' has format version %u, but only %u is supported\n",
+			filename, h.version, BINARY_VERSION );
+		exit( EXIT_FAILURE );
+	}
+	/* The points are indexed with 32 bits, and the size of the values is
+	 * compared by division, so that no product can overflow. */
+	const uint64_t rows = ( h.layout == LAYOUT_ROW ) ? h.n : h.column_stride;
+	if( h.d == 0 || h.d > BINARY_MAX_DIMS || h.layout > LAYOUT_COLUMN
+		|| h.n > UINT32_MAX
+		|| ( h.layout == LAYOUT_COLUMN && h.column_stride < h.n )
+		|| h.data_offset > ds.length
+		|| rows > ( ds.length - h.data_offset ) / sizeof( float ) / h.d ) {
+		printf( "'%s' has a corrupt header\n", filename );
+		exit( EXIT_FAILURE );
+	}
+
+	ds.data = (float*) ( (char*) ds.mapping + h.data_offset );
+	madvise( ds.mapping, ds.length, MADV_WILLNEED );
+}
+
+
+void UnmapBinaryDataset( MappedDataset &ds ) {
+	munmap( ds.mapping, ds.length );
+	ds.mapping = NULL;
+	ds.data = NULL;
+}
+
+
+Dataset* TransposeToRows( const MappedDataset &ds, bool huge_pages ) {
+	const uint32_t n = ds.header.n, d = ds.header.d;
+	Dataset *rows = new Dataset( n, d, huge_pages, false );
+#pragma omp parallel for schedule( static )
+	for( uint32_t i = 0; i < n; ++i ) {
+		for( uint32_t j = 0; j < d; ++j ) {
+			rows->row( i )[ j ] = ds.data[ j * ds.header.column_stride + i ];
+		}
+	}
+	return rows;
+}
@@ -0,0 +1,106 @@
+/**
+ * A versioned binary file format for datasets that can be mapped into
+ * memory and handed to a TKDQ solver without parsing or copying.
+ *
+ * A file consists of a fixed-size BinaryHeader followed (at offset
+ * data_offset, which is page-aligned) by n * d native-endian floats,
+ * stored either row-major (all values of a point are adjacent) or
+ * column-major (all values of a dimension are adjacent, with each
+ * column padded to a multiple of the alignment).
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#ifndef BINARY_DATASET_H_
+#define BINARY_DATASET_H_
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "common/dataset.h"
+
+const char BINARY_MAGIC[ 8 ] = { 'T', 'K', 'D', 'Q', 'B', 'I', 'N', '\0' };
+const uint32_t BINARY_VERSION = 1; /**< Version written by this build */
+const uint32_t BINARY_MAX_DIMS = 32; /**< Max dims recorded in the header */
+const uint32_t BINARY_ALIGNMENT = 64; /**< Byte alignment of the columns */
+
+/**
+ * The physical layout of the values that follow the header.
+ */
+enum BinaryLayout {
+	LAYOUT_ROW = 0, /**< Value j of point i is at index i * d + j */
+	LAYOUT_COLUMN = 1 /**< Value j of point i is at index j * stride + i */
+};
+
+/**
+ * The on-disk header of a binary dataset.
+ */
+struct BinaryHeader {
+	char magic[ 8 ]; /**< Always BINARY_MAGIC */
+	uint32_t version; /**< Format version; currently BINARY_VERSION */
+	uint32_t layout; /**< A BinaryLayout */
+	uint64_t n; /**< The number of points */
+	uint32_t d; /**< The number of dimensions */
+	uint32_t alignment; /**< Byte alignment of the data and of each column */
+	uint64_t data_offset; /**< Byte offset of the first value in the file */
+	uint64_t column_stride; /**< Floats between columns (column layout only) */
+	float min[ BINARY_MAX_DIMS ]; /**< Per-dimension minimum value */
+	float max[ BINARY_MAX_DIMS ]; /**< Per-dimension maximum value */
+};
+
+/**
+ * A binary dataset that has been mapped into memory.
+ */
+struct MappedDataset {
+	BinaryHeader header; /**< A copy of the file's header */
+	float *data; /**< The first value, pointing into the mapping */
+	void *mapping; /**< Start of the mapping (for unmapping) */
+	size_t length; /**< Length of the mapping in bytes */
+};
+
+/**
+ * Checks whether a file starts with the binary dataset magic string.
+ * @param filename The path of the file to check.
+ * @return True if the file exists and is a binary dataset.
+ */
+bool IsBinaryDataset( const char *filename );
+
+/**
+ * Writes a dataset in the binary format.
+ * @param filename The path of the file to (over)write.
+ * @param data A row-major array of n * d floats.
+ * @param n The number of points.
+ * @param d The number of dimensions; at most BINARY_MAX_DIMS.
+ * @param layout The layout in which the values should be stored.
+ * @return True on success; false if the file could not be written.
+ */
+bool WriteBinaryDataset( const char *filename, const float *data,
+	const uint32_t n, const uint32_t d, const BinaryLayout layout );
+
+/**
+ * Maps a binary dataset into memory. The mapping is private and
+ * copy-on-write, so the values may be handed to code that expects
+ * mutable data without a copy ever being made unless it writes.
+ * @param filename The path of the binary dataset.
+ * @param ds Populated with the header and mapping of the dataset.
+ * @note Exits the program if the file is missing, is not a binary
+ * dataset, or was written by a newer version.
+ */
+void MapBinaryDataset( const char *filename, MappedDataset &ds );
+
+/**
+ * Releases a mapping created by MapBinaryDataset().
+ * @param ds The mapped dataset; its data pointer is invalidated.
+ */
+void UnmapBinaryDataset( MappedDataset &ds );
+
+/**
+ * Produces a row-major copy of a column-major mapped dataset.
+ * @param ds A mapped dataset with layout LAYOUT_COLUMN.
+ * @param huge_pages True if the copy should be backed by huge pages.
+ * @return A new Dataset; the caller takes ownership.
+ */
+Dataset* TransposeToRows( const MappedDataset &ds, bool huge_pages = false );
+
+#endif /* BINARY_DATASET_H_ */
@@ -0,0 +1,32 @@
+/**
+ * Implementation of the cache size queries, via sysconf().
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#include "util/cache_size.h"
+
+#include <unistd.h>
+
+namespace {
+
+/**
+ * Returns sysconf( name ), or fallback if the system does not report it.
+ */
+uint32_t cache_size( const int name, const uint32_t fallback ) {
+	const long size = sysconf( name );
+	return size > 0 ? (uint32_t) size : fallback;
+}
+
+} // namespace
+
+uint32_t L1DataCacheSize() {
+	static const uint32_t size = cache_size( _SC_LEVEL1_DCACHE_SIZE, DEFAULT_L1D_SIZE );
+	return size;
+}
+
+uint32_t L2CacheSize() {
+	static const uint32_t size = cache_size( _SC_LEVEL2_CACHE_SIZE, DEFAULT_L2_SIZE );
+	return size;
+}
@@ -0,0 +1,27 @@
+/**
+ * The sizes of the data caches of the executing CPU, from which blocked
+ * loops derive their block sizes.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#ifndef CACHE_SIZE_H_
+#define CACHE_SIZE_H_
+
+#include <stdint.h>
+
+const uint32_t DEFAULT_L1D_SIZE = 32 << 10; /**< Assumed if the L1d size is unknown */
+const uint32_t DEFAULT_L2_SIZE = 256 << 10; /**< Assumed if the L2 size is unknown */
+
+/**
+ * Returns the size in bytes of the (per-core) L1 data cache.
+ */
+uint32_t L1DataCacheSize();
+
+/**
+ * Returns the size in bytes of the (per-core) L2 cache.
+ */
+uint32_t L2CacheSize();
+
+#endif /* CACHE_SIZE_H_ */
@@ -0,0 +1,308 @@
+/**
+ * Implementation of the memory-mapped, multi-threaded CSV loader.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#include "util/csv_loader.h"
+#include "common/common.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#else
+#define omp_get_thread_num() 0
+#define omp_get_max_threads() 1
+#endif
+
+namespace {
+
+/** Powers of ten that are exactly representable as floats. */
+const float POW10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f,
+	1e8f, 1e9f, 1e10f };
+const int32_t MAX_FAST_EXP = 10; /**< Largest exponent in POW10 */
+const uint64_t MAX_FAST_MANTISSA = 1 << 24; /**< Largest exact float integer */
+const uint32_t MAX_TOKEN_LENGTH = 128; /**< Longest number we will parse */
+const uint32_t PARSE_ERROR = ~0u; /**< Returned by parse_row() on failure */
+
+inline bool is_digit( const char c ) { return c >= '0' && c <= '9'; }
+inline bool is_blank( const char c ) { return c == ' ' || c == '\t'; }
+
+/**
+ * Parses a single float in [p, end).
+ * @param p The first character of the number.
+ * @param end One past the last character that may be read.
+ * @param out Set to the parsed value.
+ * @return One past the last character of the number, or NULL if there
+ * was no number at p.
+ * @note Numbers with at most 7 significant digits and a small decimal
+ * exponent (i.e., all of our workloads) are computed with one exactly
+ * rounded float operation on exact operands (Clinger's fast path), so
+ * the result is identical to that of strtof(), which is used for the rest.
+ */
+inline const char* parse_float( const char *p, const char *end, float &out ) {
+	const char *start = p;
+	bool negative = false;
+	if( p < end && ( *p == '-' || *p == '+' ) ) { negative = ( *p == '-' ); ++p; }
+
+	uint64_t mantissa = 0;
+	uint32_t sig_digits = 0;
+	int32_t exp10 = 0;
+	bool any_digits = false;
+	for( ; p < end && is_digit( *p ); ++p ) {
+		any_digits = true;
+		if( sig_digits < 19 ) {
+			mantissa = mantissa * 10 + ( *p - '0' );
+			if( mantissa ) { ++sig_digits; }
+		}
+		else { ++exp10; }
+	}
+	if( p < end && *p == '.' ) {
+		for( ++p; p < end && is_digit( *p ); ++p ) {
+			any_digits = true;
+			if( sig_digits < 19 ) {
+				mantissa = mantissa * 10 + ( *p - '0' );
+				if( mantissa ) { ++sig_digits; }
+				--exp10;
+			}
+		}
+	}
+	if( !any_digits ) { return NULL; }
+
+	if( p < end && ( *p == 'e' || *p == 'E' ) ) {
+		const char *q = p + 1;
+		bool exp_negative = false;
+		if( q < end && ( *q == '-' || *q == '+' ) ) { exp_negative = ( *q == '-' ); ++q; }
+		if( q < end && is_digit( *q ) ) {
+			int32_t e = 0;
+			for( ; q < end && is_digit( *q ); ++q ) {
+				if( e < 100000 ) { e = e * 10 + ( *q - '0' ); }
+			}
+			exp10 += exp_negative ? -e : e;
+			p = q;
+		}
+	}
+
+	if( mantissa <= MAX_FAST_MANTISSA && exp10 >= -MAX_FAST_EXP
+		&& exp10 <= MAX_FAST_EXP ) {
+
+		float value = (float) mantissa;
+		value = exp10 < 0 ? value / POW10[ -exp10 ] : value * POW10[ exp10 ];
+		out = negative ? -value : value;
+		return p;
+	}
+
+	/* Slow path: let the C library round it, on a NUL-terminated copy. */
+	const uint32_t length = p - start;
+	if( length >= MAX_TOKEN_LENGTH ) { return NULL; }
+	char token[ MAX_TOKEN_LENGTH ];
+	memcpy( token, start, length );
+	token[ length ] = '\0';
+	out = strtof( token, NULL );
+	return p;
+}
+
+/**
+ * Parses one row [p, eol) of comma-separated floats. A trailing comma
+ * is permitted, as it is by split().
+ * @param out Destination for the values; must have room for max_values.
+ * @return The number of values parsed, or PARSE_ERROR if the row is
+ * malformed or has more than max_values values.
+ */
+uint32_t parse_row( const char *p, const char *eol, const bool has_line_numbers,
+	float *out, const uint32_t max_values ) {
+
+	if( has_line_numbers ) {
+		while( p < eol && *p != ',' ) { ++p; }
+		if( p == eol ) { return 0; }
+		++p;
+	}
+
+	uint32_t count = 0;
+	while( true ) {
+		while( p < eol && is_blank( *p ) ) { ++p; }
+		if( p == eol ) { break; } // empty row or trailing comma
+		if( count == max_values ) { return PARSE_ERROR; }
+		p = parse_float( p, eol, out[ count ] );
+		if( p == NULL ) { return PARSE_ERROR; }
+		++count;
+		while( p < eol && is_blank( *p ) ) { ++p; }
+		if( p == eol ) { break; }
+		if( *p != ',' ) { return PARSE_ERROR; }
+		++p;
+	}
+	return count;
+}
+
+/**
+ * Returns one past the last character of the line starting at p,
+ * excluding the newline and any carriage return.
+ */
+inline const char* end_of_line( const char *p, const char *end, const char **next ) {
+	const char *nl = (const char*) memchr( p, '\n', end - p );
+	*next = nl ? nl + 1 : end;
+	const char *eol = nl ? nl : end;
+	if( eol > p && *( eol - 1 ) == '\r' ) { --eol; }
+	return eol;
+}
+
+/** Returns true if [p, eol) contains only whitespace. */
+inline bool is_blank_line( const char *p, const char *eol ) {
+	while( p < eol && is_blank( *p ) ) { ++p; }
+	return p == eol;
+}
+
+} // namespace
+
+
+Dataset* LoadCSV( const char *filename, bool has_line_numbers,
+	bool normalize, bool huge_pages, bool tuple_rows,
+	RowBlockConsumer *consumer ) {
+
+	/* Map the entire file into memory. */
+	const int fd = open( filename, O_RDONLY );
+	struct stat st;
+	if( fd < 0 || fstat( fd, &st ) != 0 ) {
+		printf( "Can't find '%s' file\n", filename );
+		exit( EXIT_FAILURE );
+	}
+	const size_t size = st.st_size;
+	if( size == 0 ) {
+		printf( "File '%s' is empty\n", filename );
+		exit( EXIT_FAILURE );
+	}
+	void *mapping = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	close( fd );
+	if( mapping == MAP_FAILED ) {
+		printf( "Can't map '%s' file\n", filename );
+		exit( EXIT_FAILURE );
+	}
+	madvise( mapping, size, MADV_WILLNEED );
+	const char *begin = (const char*) mapping, *end = begin + size;
+
+	/* Determine the dimensionality from the first non-empty row. */
+	const char *p = begin, *next;
+	const char *eol = end_of_line( p, end, &next );
+	while( is_blank_line( p, eol ) && next < end ) {
+		p = next;
+		eol = end_of_line( p, end, &next );
+	}
+	std::vector< float > first_row( eol - p + 1 );
+	const uint32_t d = parse_row( p, eol, has_line_numbers, first_row.data(), first_row.size() );
+	if( d == PARSE_ERROR || d == 0 ) {
+		printf( "Can't parse the first row of '%s'\n", filename );
+		exit( EXIT_FAILURE );
+	}
+
+	/* Cut the file into newline-aligned chunks, one per thread. */
+	const uint32_t num_chunks = omp_get_max_threads();
+	std::vector< const char* > chunk_start( num_chunks + 1 );
+	chunk_start[ 0 ] = begin;
+	chunk_start[ num_chunks ] = end;
+	for( uint32_t c = 1; c < num_chunks; ++c ) {
+		const char *raw = begin + ( size * c ) / num_chunks;
+		if( raw == begin ) { chunk_start[ c ] = begin; continue; }
+		const char *nl = (const char*) memchr( raw - 1, '\n', end - raw + 1 );
+		chunk_start[ c ] = nl ? nl + 1 : end;
+	}
+
+	/* Count the rows in each chunk, then prefix-sum them into offsets. */
+	std::vector< uint64_t > chunk_offset( num_chunks + 1, 0 );
+#pragma omp parallel for schedule( static, 1 ) num_threads( num_chunks )
+	for( uint32_t c = 0; c < num_chunks; ++c ) {
+		uint64_t rows = 0;
+		for( const char *q = chunk_start[ c ], *next_line; q < chunk_start[ c + 1 ]; q = next_line ) {
+			const char *line_end = end_of_line( q, chunk_start[ c + 1 ], &next_line );
+			if( !is_blank_line( q, line_end ) ) { ++rows; }
+		}
+		chunk_offset[ c + 1 ] = rows;
+	}
+	for( uint32_t c = 0; c < num_chunks; ++c ) {
+		chunk_offset[ c + 1 ] += chunk_offset[ c ];
+	}
+	const uint32_t n = chunk_offset[ num_chunks ];
+
+	/* Parse every chunk directly into its slice of the output, meanwhile 
+	 * reducing per-chunk bounds (seeded with the first row) if normalizing 
+	 * or else handing each block of rows to the consumer, from the thread 
+	 * that parsed it, as soon as it is complete. The thread count is fixed
+	 * to the number of chunks, since Begin() may change the default. */
+	Dataset *dataset = new Dataset( n, d, huge_pages, false,
+		tuple_rows ? TupleRowStride( d ) : d );
+	if( consumer != NULL ) { consumer->Begin( *dataset ); }
+	const bool stream = ( consumer != NULL && !normalize );
+	std::vector< uint64_t > bad_row( num_chunks, ~0ull );
+	std::vector< float > chunk_min( num_chunks * d ), chunk_max( num_chunks * d );
+#pragma omp parallel for schedule( static, 1 ) num_threads( num_chunks )
+	for( uint32_t c = 0; c < num_chunks; ++c ) {
+		float *my_min = &chunk_min[ c * d ], *my_max = &chunk_max[ c * d ];
+		for( uint32_t j = 0; j < d; ++j ) { my_min[ j ] = my_max[ j ] = first_row[ j ]; }
+
+		uint64_t row = chunk_offset[ c ], block_start = row;
+		for( const char *q = chunk_start[ c ], *next_line; q < chunk_start[ c + 1 ]; q = next_line ) {
+			const char *line_end = end_of_line( q, chunk_start[ c + 1 ], &next_line );
+			if( !is_blank_line( q, line_end ) ) {
+				float *values = dataset->row( row );
+				if( parse_row( q, line_end, has_line_numbers, values, d ) != d ) {
+					bad_row[ c ] = row;
+					break;
+				}
+				if( normalize ) {
+					for( uint32_t j = 0; j < d; ++j ) {
+						my_min[ j ] = std::min( my_min[ j ], values[ j ] );
+						my_max[ j ] = std::max( my_max[ j ], values[ j ] );
+					}
+				}
+				if( ++row - block_start == CSV_BLOCK_ROWS && stream ) {
+					consumer->Consume( *dataset, block_start, row );
+					block_start = row;
+				}
+			}
+		}
+		if( stream && row > block_start && bad_row[ c ] == ~0ull ) {
+			consumer->Consume( *dataset, block_start, row );
+		}
+	}
+	munmap( mapping, size );
+
+	for( uint32_t c = 0; c < num_chunks; ++c ) {
+		if( bad_row[ c ] != ~0ull ) {
+			printf( "Can't parse row %llu of '%s' (expected %u values)\n",
+				(unsigned long long) bad_row[ c ] + 1, filename, d );
+			exit( EXIT_FAILURE );
+		}
+	}
+
+	/* Complete the reduction of the bounds and rescale in one pass. */
+	if( normalize ) {
+		for( uint32_t c = 1; c < num_chunks; ++c ) {
+			for( uint32_t j = 0; j < d; ++j ) {
+				chunk_min[ j ] = std::min( chunk_min[ j ], chunk_min[ c * d + j ] );
+				chunk_max[ j ] = std::max( chunk_max[ j ], chunk_max[ c * d + j ] );
+			}
+		}
+		dataset->Normalize( &chunk_min[ 0 ], &chunk_max[ 0 ] );
+
+		/* Only now are the rows final, so hand them over in parallel blocks. */
+		if( consumer != NULL ) {
+			const uint32_t num_blocks = n / CSV_BLOCK_ROWS + ( n % CSV_BLOCK_ROWS != 0 );
+#pragma omp parallel for schedule( dynamic ) num_threads( num_chunks )
+			for( uint32_t b = 0; b < num_blocks; ++b ) {
+				consumer->Consume( *dataset, b * CSV_BLOCK_ROWS, 
+					std::min( n, ( b + 1 ) * CSV_BLOCK_ROWS ) );
+			}
+		}
+	}
+	return dataset;
+}
@@ -0,0 +1,80 @@
+/**
+ * Memory-mapped, multi-threaded loader for comma-separated input files.
+ *
+ * The file is mapped into memory and cut into newline-aligned chunks, one
+ * per thread. Each thread first counts the rows in its chunk so that every
+ * chunk knows its offset into the output, and then parses its rows directly
+ * into one contiguous, row-major buffer. No intermediate vectors or strings
+ * are created. Optionally, blocks of parsed rows are handed to a consumer
+ * while the rest of the file is still being parsed.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#ifndef CSV_LOADER_H_
+#define CSV_LOADER_H_
+
+#include <stdint.h>
+
+#include "common/dataset.h"
+
+const uint32_t CSV_BLOCK_ROWS = 1 << 14; /**< Rows per block handed to a consumer */
+
+/**
+ * Receives the rows of a Dataset from LoadCSV() as they are parsed, so
+ * that work on them can overlap with parsing the rest of the file.
+ */
+class RowBlockConsumer {
+
+public:
+
+	virtual ~RowBlockConsumer() { }
+
+	/**
+	 * Called once the size of the dataset is known, before any rows
+	 * have been parsed into it.
+	 * @param data The (still unpopulated) dataset.
+	 */
+	virtual void Begin( const Dataset &data ) { }
+
+	/**
+	 * Called once for every block of (at most CSV_BLOCK_ROWS) rows, as
+	 * soon as they are final. Blocks arrive in no particular order and
+	 * from any parser thread, possibly concurrently (but are disjoint).
+	 * @param data The dataset, of which only rows [begin, end) (and
+	 * those of earlier blocks) may be read.
+	 * @param begin The first row of the block.
+	 * @param end One past the last row of the block.
+	 */
+	virtual void Consume( const Dataset &data, const uint32_t begin,
+		const uint32_t end ) = 0;
+};
+
+/**
+ * Reads the comma-separated file at filename into a Dataset.
+ * @param filename The path of the file to be read.
+ * @param has_line_numbers True if the first field of every row is a line
+ * number that should be discarded.
+ * @param normalize True if the values should be normalized to [0,1]^d.
+ * @param huge_pages True if the Dataset should be backed by huge pages.
+ * @param tuple_rows True if each row should be laid out as a PTuple
+ * (with a row stride of TupleRowStride( d )) rather than packed.
+ * Only the values of each row are written.
+ * @param consumer If not NULL, receives every row as soon as it is parsed
+ * (or, if normalizing, only once all rows have been parsed and rescaled,
+ * though still in blocks, in parallel).
+ * @return A Dataset with one point per (non-empty) row and as many
+ * dimensions as the first row has values. The caller takes ownership.
+ * Each page of the Dataset is first touched by the thread that parses it.
+ * If normalize is set, every dimension is rescaled to [0,1]; the bounds 
+ * for that are reduced per thread during the parse, so normalization costs 
+ * only one extra in-place pass rather than a parse and a copy.
+ * @note Exits the program if the file cannot be read or a row has a
+ * different number of values than the first one, mirroring read_data().
+ */
+Dataset* LoadCSV( const char *filename, bool has_line_numbers,
+	bool normalize = false, bool huge_pages = false, bool tuple_rows = false,
+	RowBlockConsumer *consumer = NULL );
+
+#endif /* CSV_LOADER_H_ */
@@ -0,0 +1,75 @@
+/**
+ * Implementation of instruction set family detection and dispatch.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#include "util/isa_dispatch.h"
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+
+#include <limits.h>
+#include <unistd.h>
+
+namespace {
+
+const char *ISA_NAMES[ NUM_ISAS ] = { "scalar", "sse4", "avx2", "avx512" };
+
+const char *EXECUTABLE_NAME = "ParallelTKDQ"; /**< The name of the scalar build */
+
+} // namespace
+
+Isa DetectIsa() {
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" )
+			&& __builtin_cpu_supports( "avx512vl" ) ) {
+		return ISA_AVX512;
+	}
+	if( __builtin_cpu_supports( "avx2" ) ) { return ISA_AVX2; }
+	if( __builtin_cpu_supports( "sse4.2" ) && __builtin_cpu_supports( "popcnt" ) ) {
+		return ISA_SSE4;
+	}
+	return ISA_SCALAR;
+}
+
+const char* IsaName( const Isa isa ) {
+	return ISA_NAMES[ isa ];
+}
+
+bool ParseIsa( const std::string &name, Isa &isa ) {
+	for( uint32_t i = 0; i < NUM_ISAS; ++i ) {
+		if( name == ISA_NAMES[ i ] ) {
+			isa = (Isa) i;
+			return true;
+		}
+	}
+	return false;
+}
+
+Isa DispatchIsa( const Isa isa, char **argv ) {
+
+	/* The builds live side by side, so find the one for isa next to this one. */
+	char path[ PATH_MAX ];
+	const ssize_t len = readlink( "/proc/self/exe", path, sizeof( path ) - 1 );
+	path[ len > 0 ? len : 0 ] = '\0';
+	char *base = strrchr( path, '/' );
+	base = ( base == NULL ? path : base + 1 );
+
+	/* Try isa and then each less capable family, until one is this build
+	 * or its build replaces this process. */
+	for( int32_t i = isa; i >= ISA_SCALAR; --i ) {
+		if( i == BUILD_ISA ) { return BUILD_ISA; }
+		if( len <= 0 ) { continue; }
+		if( i == ISA_SCALAR ) {
+			snprintf( base, path + sizeof( path ) - base, "%s", EXECUTABLE_NAME );
+		}
+		else {
+			snprintf( base, path + sizeof( path ) - base, "%s-%s", EXECUTABLE_NAME, IsaName( (Isa) i ) );
+		}
+		execv( path, argv ); // only returns if it failed
+	}
+	return NUM_ISAS;
+}
@@ -0,0 +1,74 @@
+/**
+ * Selection of the instruction set family that the dominance tests use.
+ *
+ * The kernels in common/ choose their instructions at compile time, so
+ * that they inline into the innermost loops of the solvers. The makefile
+ * therefore builds the whole driver once per family: as ParallelTKDQ
+ * (scalar, runs on any x86-64) and as ParallelTKDQ-<isa>. At startup,
+ * the driver detects the best family that the CPU supports (or takes
+ * one from the command line) and, if that is not its own, replaces
+ * itself with the matching build.
+ *
+ * @date 17 Oct 2026
+ * @author Sean Chester
+ */
+
+#ifndef ISA_DISPATCH_H_
+#define ISA_DISPATCH_H_
+
+#include <string>
+
+/**
+ * The instruction set families, in increasing order of capability.
+ */
+enum Isa {
+	ISA_SCALAR = 0, /**< Plain x86-64 (SSE2 only): scalar dominance tests */
+	ISA_SSE4 = 1, /**< SSE4.2 and POPCNT: 128-bit dominance tests */
+	ISA_AVX2 = 2, /**< AVX2: 256-bit dominance tests */
+	ISA_AVX512 = 3, /**< AVX-512 F/BW/VL: dominance tests on mask registers */
+	NUM_ISAS = 4
+};
+
+/** The family that this translation unit (hence this build) targets. */
+#if __AVX512F__ && __AVX512BW__ && __AVX512VL__
+const Isa BUILD_ISA = ISA_AVX512;
+#elif __AVX2__
+const Isa BUILD_ISA = ISA_AVX2;
+#elif __SSE4_2__ && __POPCNT__
+const Isa BUILD_ISA = ISA_SSE4;
+#else
+const Isa BUILD_ISA = ISA_SCALAR;
+#endif
+
+/**
+ * Returns the most capable family that the executing CPU supports.
+ */
+Isa DetectIsa();
+
+/**
+ * Returns the name of a family ("scalar", "sse4", "avx2", or "avx512").
+ */
+const char* IsaName( const Isa isa );
+
+/**
+ * Parses the name of a family, as returned by IsaName().
+ * @return False if name is not the name of any family.
+ */
+bool ParseIsa( const std::string &name, Isa &isa );
+
+/**
+ * Ensures that the process runs the build for a family: returns at once
+ * if this is that build and otherwise replaces the process (with the
+ * same arguments) by the sibling build next to this executable. If that
+ * build is missing or cannot be executed, falls back in the same way to
+ * each less capable family in turn, down to scalar.
+ * @param isa The family to run; it must be supported by the CPU.
+ * @param argv The arguments with which the process was started.
+ * @return The family with which this build continues: isa, or a less 
+ * capable one that is this build's own. NUM_ISAS if no build for isa or 
+ * below could be executed and this build is more capable than isa (so 
+ * it may only continue if the CPU supports BUILD_ISA).
+ */
+Isa DispatchIsa( const Isa isa, char **argv );
+
+#endif /* ISA_DISPATCH_H_ */
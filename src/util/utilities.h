@@ -19,20 +19,6 @@
 #define DOM_INCOMPARABLE 0
 using namespace std;
 
-float** AllocateDoubleArray(const unsigned row, const unsigned col) {
-  float** matrix = new float*[row];
-  for (unsigned i = 0; i < row; i++)
-    matrix[i] = new float[col];
-
-  return matrix;
-}
-
-void FreeDoubleArray(const unsigned row, float** matrix) {
-  for (unsigned i = 0; i < row; i++)
-    delete[] matrix[i];
-  delete[] matrix;
-}
-
 void PrintSkyline(const vector<int> &sky) {
 //  printf(" ids:");
   for (uint32_t i = 0; i < sky.size(); ++i) {